@@ -0,0 +1,84 @@
+#ifndef PERFGATE_H
+#define PERFGATE_H
+
+#include "bench/pipelinebenchmark.h"
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @brief Verdict for one gated scenario
+ */
+struct GateOutcome
+{
+    QString key;              // "<benchmark>@<resolution>"
+    double framesPerSecond = 0.0;
+    double p99Ms = 0.0;
+    double baselineFramesPerSecond = 0.0;
+    double baselineP99Ms = 0.0;
+    bool hasBaseline = false;
+    bool regressed = false;
+};
+
+/**
+ * @brief Performance regression gate over a fixed set of pipeline scenarios
+ *
+ * Runs the scenarios on synthetic clips and compares frames per second and
+ * p99 latency with a baseline stored per machine (<baselineDir>/<hostname>.json).
+ * A scenario regresses when its throughput drops, or its p99 grows, by more
+ * than the tolerance. Scenarios missing from the baseline are added to it.
+ * Without a baseline file the run records one and warns, or fails when a
+ * baseline is required (CI, where hosts don't live to see a second run).
+ *
+ * Scenarios: decode only (MJPEG) and edge detection + overlay through
+ * VideoPluginManager, at 720p and 1080p. Nothing needs a GPU, a display or
+ * network access.
+ */
+class PerfGate
+{
+public:
+    struct Options
+    {
+        QString baselineDir;
+        double tolerance = 0.25;   // Relative; histogram percentiles resolve to about 12%
+        bool updateBaseline = false;
+        bool requireBaseline = false; // Fail instead of only recording a missing baseline
+        int iterations = 120;
+        int warmup = 10;
+    };
+
+    explicit PerfGate(const Options& options);
+
+    /**
+     * @brief Runs the scenarios and compares them with the baseline
+     * @return true if no scenario regressed
+     */
+    bool run();
+
+    /**
+     * @brief Outcomes of the last run()
+     */
+    QList<GateOutcome> outcomes() const;
+
+    /**
+     * @brief Baseline file of this machine
+     */
+    QString baselinePath() const;
+
+    /**
+     * @brief Benchmark names the gate runs
+     */
+    static QStringList scenarios();
+
+private:
+    static QString keyFor(const BenchmarkResult& result);
+    bool loadBaseline(QJsonObject& scenarios) const;
+    bool saveBaseline(const QJsonObject& scenarios) const;
+    void report() const;
+
+    Options m_options;
+    QList<GateOutcome> m_outcomes;
+};
+
+#endif // PERFGATE_H
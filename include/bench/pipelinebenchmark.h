@@ -0,0 +1,111 @@
+#ifndef PIPELINEBENCHMARK_H
+#define PIPELINEBENCHMARK_H
+
+#include "core/latencyhistogram.h"
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include <opencv2/core.hpp>
+#include <vector>
+
+class RawFrameReader;
+
+/**
+ * @brief Timing of one benchmark at one resolution
+ */
+struct BenchmarkResult
+{
+    QString name;
+    QString resolution;     // e.g. "1080p"
+    QString source;         // "synthetic" or the replayed capture file
+    int iterations = 0;
+    LatencyStats stats;     // Exact, from every timed sample
+    double framesPerSecond = 0.0; // 1000 / mean latency
+};
+
+/**
+ * @brief Microbenchmarks of the frame pipeline on synthetic video
+ *
+ * Frames are generated in memory (gradients, moving shapes and noise, so
+ * edge detection has work to do), which keeps runs reproducible and
+ * independent of codecs and disk. Covers decoding (MJPEG, through
+ * OpenCV's built-in codec so no FFmpeg is needed), the BGR->RGB conversion done in
+ * VideoGLWidget::updateFrame, VideoPluginManager::processFrame with each
+ * built-in plugin, the fused edge blend kernel, raster label drawing and
+ * texture upload on an offscreen GL context.
+ *
+ * With Options::replayPath set, the frames of a raw capture (see
+ * RawFrameWriter) are used instead, at the capture's resolution: the
+ * manager scenarios replay every frame through RawFrameReplay straight
+ * from the file mapping, the other benchmarks use its first frames.
+ */
+class PipelineBenchmark
+{
+public:
+    struct Options
+    {
+        int iterations = 100;
+        int warmup = 10;
+        QStringList filters;     // Only run benchmarks whose name contains one of these
+        bool textureUpload = true;
+        QString replayPath;      // Raw frame capture to use instead of synthetic clips
+        std::vector<cv::Size> resolutions = {cv::Size(1280, 720), cv::Size(1920, 1080), cv::Size(3840, 2160)};
+    };
+
+    explicit PipelineBenchmark(const Options& options);
+
+    /**
+     * @brief Runs every selected benchmark at every resolution
+     */
+    QList<BenchmarkResult> run();
+
+    /**
+     * @brief Machine description stored next to the results
+     */
+    static QJsonObject machineInfo();
+
+    /**
+     * @brief Serializes results together with the machine description
+     */
+    static QJsonObject toJson(const QList<BenchmarkResult>& results);
+
+    /**
+     * @brief Deterministic BGR clip with motion between frames
+     * @param size Frame size
+     * @param frames Number of frames
+     */
+    static std::vector<cv::Mat> syntheticClip(const cv::Size& size, int frames);
+
+    /**
+     * @brief Short name of a resolution ("720p", "1080p", "4K" or WxH)
+     */
+    static QString resolutionName(const cv::Size& size);
+
+private:
+    void runAll(const cv::Size& size, const std::vector<cv::Mat>& clip, const std::vector<cv::Mat>& rgbClip);
+    void benchDecode(const cv::Size& size, const std::vector<cv::Mat>& clip);
+    void benchConversion(const cv::Size& size, const std::vector<cv::Mat>& clip);
+    void benchPluginManager(const cv::Size& size, const std::vector<cv::Mat>& rgbClip);
+    void benchApplyColorToEdges(const cv::Size& size, const std::vector<cv::Mat>& rgbClip);
+    void benchDrawText(const cv::Size& size, const std::vector<cv::Mat>& rgbClip);
+    void benchTextureUpload(const cv::Size& size, const std::vector<cv::Mat>& rgbClip);
+
+    bool selected(const QString& name) const;
+
+    /**
+     * @brief Times body(i) over warmup + iterations runs
+     * @param prepare Untimed setup before each run (may be null)
+     */
+    void measure(const QString& name, const cv::Size& size,
+                 const std::function<void(int)>& prepare,
+                 const std::function<void(int)>& body);
+
+    Options m_options;
+    QString m_source;
+    const RawFrameReader* m_replayReader; // Set while a capture is replayed
+    QList<BenchmarkResult> m_results;
+};
+
+#endif // PIPELINEBENCHMARK_H
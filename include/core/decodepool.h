@@ -0,0 +1,46 @@
+#ifndef DECODEPOOL_H
+#define DECODEPOOL_H
+
+#include <QThreadPool>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Bounded set of threads shared by all decoding streams
+ *
+ * The multi-view grid decodes one frame per stream on every vsync. Doing it
+ * on the UI thread serializes the streams; a thread per stream oversubscribes
+ * the CPU as views are added. The pool runs a batch of jobs (one per stream)
+ * on at most a fixed number of threads and returns when all are done, so
+ * every view of a tick shows the same media time.
+ *
+ * The calling thread runs one job itself rather than idling while it waits.
+ * Jobs of a batch must not share state.
+ */
+class DecodePool
+{
+public:
+    /**
+     * @param maxThreads Worker threads, 0 for one less than the cores (capped)
+     */
+    explicit DecodePool(int maxThreads = 0);
+    ~DecodePool();
+
+    DecodePool(const DecodePool&) = delete;
+    DecodePool& operator=(const DecodePool&) = delete;
+
+    /**
+     * @brief Worker threads, not counting the calling thread
+     */
+    int maxThreadCount() const;
+
+    /**
+     * @brief Runs the jobs concurrently and returns when all have finished
+     */
+    void runAll(const std::vector<std::function<void()>>& jobs);
+
+private:
+    QThreadPool m_pool;
+};
+
+#endif // DECODEPOOL_H
@@ -0,0 +1,175 @@
+#ifndef FRAMECONTEXT_H
+#define FRAMECONTEXT_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <typeinfo>
+#include <utility>
+
+/**
+ * @brief Well-known frame context keys
+ *
+ * Values are published at the resolution of the frame the producer worked
+ * on, which in proxy mode can be smaller than the source.
+ */
+namespace FrameKeys {
+inline const QString Gray = QStringLiteral("frame.gray");               // cv::Mat, CV_8UC1
+inline const QString Landmarks = QStringLiteral("pose.landmarks");      // std::vector<cv::Point3f>
+inline const QString SegmentationMask = QStringLiteral("pose.mask");    // cv::Mat, CV_8UC1
+} // namespace FrameKeys
+
+/**
+ * @brief Per-frame typed key/value store shared by the plugin chain
+ *
+ * Producers publish results (gray planes, landmarks, masks) and consumers
+ * read them later in the same frame instead of recomputing them. Values
+ * are held through std::shared_ptr<const T>, so reading never copies and
+ * a consumer that needs a value beyond the frame can keep its pointer.
+ *
+ * Values are only valid for the frame they were published in: the manager
+ * drops each entry after its last consumer has run and clears the context
+ * when the frame retires. A producer that shares a reusable buffer (e.g. a
+ * cv::Mat member) should reallocate it if a consumer kept it alive.
+ */
+class FrameContext
+{
+public:
+    FrameContext()
+        : FrameContext(0, 0)
+    {
+    }
+
+    FrameContext(qint64 timestamp, qint64 frameIndex)
+        : m_timestamp(timestamp)
+        , m_frameIndex(frameIndex)
+        , m_wantsAll(true)
+        , m_frameWritable(true)
+    {
+    }
+
+    FrameContext(const FrameContext&) = delete;
+    FrameContext& operator=(const FrameContext&) = delete;
+
+    /**
+     * @brief Starts a new frame, dropping all entries
+     * @param timestamp Frame timestamp in milliseconds
+     * @param frameIndex Frame index
+     */
+    void reset(qint64 timestamp, qint64 frameIndex)
+    {
+        m_entries.clear();
+        m_timestamp = timestamp;
+        m_frameIndex = frameIndex;
+    }
+
+    /**
+     * @brief Drops all entries, releasing the values nobody else holds
+     */
+    void clear()
+    {
+        m_entries.clear();
+    }
+
+    qint64 timestamp() const { return m_timestamp; }
+    qint64 frameIndex() const { return m_frameIndex; }
+
+    /**
+     * @brief Publishes a value, replacing any previous one under the key
+     */
+    template<typename T>
+    void publish(const QString& key, std::shared_ptr<const T> value)
+    {
+        Entry entry;
+        entry.type = &typeid(T);
+        entry.value = std::move(value);
+        m_entries.insert(key, std::move(entry));
+    }
+
+    /**
+     * @brief Publishes a value by moving it into shared storage
+     */
+    template<typename T>
+    void publish(const QString& key, T value)
+    {
+        publish<T>(key, std::shared_ptr<const T>(std::make_shared<T>(std::move(value))));
+    }
+
+    /**
+     * @brief Reads a value
+     * @return The value, or nullptr if missing or published with another type
+     */
+    template<typename T>
+    std::shared_ptr<const T> get(const QString& key) const
+    {
+        auto it = m_entries.constFind(key);
+        // Compare type_info by value, pointers differ across plugin libraries
+        if (it == m_entries.constEnd() || *it->type != typeid(T)) {
+            return nullptr;
+        }
+        return std::static_pointer_cast<const T>(it->value);
+    }
+
+    bool contains(const QString& key) const
+    {
+        return m_entries.contains(key);
+    }
+
+    void remove(const QString& key)
+    {
+        m_entries.remove(key);
+    }
+
+    QStringList keys() const
+    {
+        return m_entries.keys();
+    }
+
+    /**
+     * @brief Whether any plugin later in the chain consumes a key
+     *
+     * Producers can skip work nobody reads. Always true outside a managed
+     * chain.
+     */
+    bool wants(const QString& key) const
+    {
+        return m_wantsAll || m_wanted.contains(key);
+    }
+
+    /**
+     * @brief Restricts wants() to a set of consumed keys (manager)
+     */
+    void setWantedKeys(const QSet<QString>& keys)
+    {
+        m_wanted = keys;
+        m_wantsAll = false;
+    }
+
+    /**
+     * @brief Whether the running plugin was granted write access to the frame
+     *
+     * Set by the manager from frameAccess() before each plugin. Always true
+     * outside a managed chain, where the caller owns the frame.
+     */
+    bool frameWritable() const { return m_frameWritable; }
+    void setFrameWritable(bool writable) { m_frameWritable = writable; }
+
+private:
+    struct Entry
+    {
+        const std::type_info* type = nullptr;
+        std::shared_ptr<const void> value;
+    };
+
+    QHash<QString, Entry> m_entries;
+    qint64 m_timestamp;
+    qint64 m_frameIndex;
+
+    QSet<QString> m_wanted;
+    bool m_wantsAll;
+    bool m_frameWritable;
+};
+
+#endif // FRAMECONTEXT_H
@@ -0,0 +1,61 @@
+#ifndef FRAMEPYRAMID_H
+#define FRAMEPYRAMID_H
+
+#include "memoryaccountant.h"
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * @brief Lazily built resolution pyramid of a single frame
+ *
+ * Level 0 is the source frame (shared, not copied). Each further level
+ * halves both dimensions and is only computed when a consumer asks for a
+ * size it can satisfy. Level buffers are reused from frame to frame and
+ * charged to MemorySubsystem::PluginScratch.
+ */
+class FramePyramid
+{
+public:
+    FramePyramid();
+
+    /**
+     * @brief Starts a new frame
+     * @param base Full resolution frame (level 0)
+     */
+    void reset(const cv::Mat& base);
+
+    /**
+     * @brief Returns the smallest level at least as large as minimum
+     *
+     * An empty minimum size selects level 0 (full resolution).
+     *
+     * @param minimum Minimum width and height required
+     */
+    cv::Mat& levelFor(const cv::Size& minimum);
+
+    /**
+     * @brief Size of the level levelFor() would return, without building it
+     */
+    cv::Size levelSizeFor(const cv::Size& minimum) const;
+
+    /**
+     * @brief Number of levels computed for the current frame
+     */
+    int builtLevels() const;
+
+    /**
+     * @brief Whether a matrix shares its buffer with one of the levels
+     */
+    bool holds(const cv::Mat& mat) const;
+
+private:
+    int levelIndexFor(const cv::Size& minimum) const;
+    static cv::Size levelSize(const cv::Size& base, int level);
+    void updateCharge();
+
+    std::vector<cv::Mat> m_levels;
+    int m_builtLevels;
+    MemoryCharge m_charge; // Levels above 0, which are owned here
+};
+
+#endif // FRAMEPYRAMID_H
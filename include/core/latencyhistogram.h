@@ -0,0 +1,92 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <chrono>
+
+/**
+ * @brief Latency summary of a histogram
+ */
+struct LatencyStats
+{
+    qint64 count = 0;
+    double meanMs = 0.0;
+    double p50Ms = 0.0;
+    double p95Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+};
+
+/**
+ * @brief Fixed-size log-scale latency histogram
+ *
+ * Each power of two of microseconds is split into four buckets, covering
+ * 1 us to about a minute in 104 counters, so percentiles are within about
+ * 12% of the true value while the maximum is exact. record() is a handful
+ * of relaxed atomic operations and never allocates, so it can sit in the
+ * frame path and be read from the UI thread at any time.
+ */
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+
+    /**
+     * @brief Records one sample (any thread)
+     * @param nanoseconds Measured duration
+     */
+    void record(qint64 nanoseconds);
+
+    /**
+     * @brief Computes percentiles of the samples recorded so far (any thread)
+     */
+    LatencyStats stats() const;
+
+    /**
+     * @brief Drops all samples
+     */
+    void reset();
+
+private:
+    static const int kSubBuckets = 4;
+    static const int kBucketCount = 104;
+
+    static int bucketFor(qint64 microseconds);
+    static double bucketMidpointMs(int bucket);
+
+    std::array<std::atomic<quint64>, kBucketCount> m_buckets;
+    std::atomic<qint64> m_totalNs;
+    std::atomic<qint64> m_maxNs;
+};
+
+/**
+ * @brief Records the lifetime of a scope into a histogram
+ */
+class ScopedLatency
+{
+public:
+    explicit ScopedLatency(LatencyHistogram* histogram)
+        : m_histogram(histogram)
+        , m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~ScopedLatency()
+    {
+        if (m_histogram) {
+            auto elapsed = std::chrono::steady_clock::now() - m_start;
+            m_histogram->record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyHistogram* m_histogram;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,245 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+/**
+ * @brief Log levels, ordered by severity
+ */
+enum class LogLevel : int {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warning = 3,
+    Error = 4
+};
+
+// Messages below this level are compiled out, arguments included
+#ifndef BLAZESTUDIO_LOG_LEVEL
+#ifdef NDEBUG
+#define BLAZESTUDIO_LOG_LEVEL 2
+#else
+#define BLAZESTUDIO_LOG_LEVEL 1
+#endif
+#endif
+
+/**
+ * @brief Static description of one log statement
+ *
+ * Each LOG_* macro owns one, which also rate limits that call site: at
+ * most kMessagesPerSecond messages get through per second, the rest are
+ * counted and reported with the next message that passes.
+ */
+class LogSite
+{
+public:
+    static const int kMessagesPerSecond = 10;
+
+    LogSite(LogLevel level, const char* category)
+        : level(level)
+        , category(category)
+        , m_windowStartMs(0)
+        , m_windowCount(0)
+        , m_suppressed(0)
+    {
+    }
+
+    /**
+     * @brief Whether a message may be logged now (any thread)
+     */
+    bool admit();
+
+    /**
+     * @brief Messages dropped since the last one that got through
+     */
+    int takeSuppressed()
+    {
+        return m_suppressed.exchange(0, std::memory_order_relaxed);
+    }
+
+    const LogLevel level;
+    const char* const category;
+
+private:
+    std::atomic<qint64> m_windowStartMs;
+    std::atomic<int> m_windowCount;
+    std::atomic<int> m_suppressed;
+};
+
+/**
+ * @brief Asynchronous logger with deferred formatting
+ *
+ * A log call copies its arguments (numbers by value, strings into a small
+ * inline buffer) into a fixed-size record and pushes it into a bounded
+ * lock-free queue; formatting and the actual qDebug/qWarning output happen
+ * on a background thread. A full queue drops the message and counts it
+ * instead of blocking the caller.
+ *
+ * Use the LOG_* macros rather than calling log() directly.
+ */
+class Logger
+{
+public:
+    static const int kMaxArgs = 8;
+    static const int kTextBytes = 160;
+
+    static Logger& instance();
+
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * @brief Queues a message (any thread)
+     * @param format String literal; "%1".."%8" are replaced by the arguments
+     */
+    template<typename... Args>
+    void log(LogSite& site, const char* format, const Args&... args)
+    {
+        static_assert(sizeof...(Args) <= kMaxArgs, "Too many log arguments");
+
+        Record record;
+        record.site = &site;
+        record.format = format;
+        record.suppressed = site.takeSuppressed();
+        record.argCount = 0;
+        record.textUsed = 0;
+        (capture(record, args), ...);
+        push(record);
+    }
+
+    /**
+     * @brief Blocks until everything queued so far has been written
+     */
+    void flush();
+
+    /**
+     * @brief Messages lost because the queue was full
+     */
+    qint64 droppedMessages() const;
+
+private:
+    enum class ArgType : quint8 { Int, UInt, Double, Bool, Text };
+
+    struct Arg
+    {
+        ArgType type;
+        union {
+            qint64 i;
+            quint64 u;
+            double d;
+            struct {
+                quint16 offset;
+                quint16 length;
+            } text;
+        };
+    };
+
+    struct Record
+    {
+        LogSite* site;
+        const char* format;
+        int suppressed;
+        int argCount;
+        int textUsed;
+        Arg args[kMaxArgs];
+        char text[kTextBytes];
+    };
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        Record record;
+    };
+
+    Logger();
+
+    template<typename T>
+    static void capture(Record& record, const T& value)
+    {
+        Arg& arg = record.args[record.argCount++];
+        if constexpr (std::is_same_v<T, bool>) {
+            arg.type = ArgType::Bool;
+            arg.u = value ? 1 : 0;
+        } else if constexpr (std::is_enum_v<T>) {
+            arg.type = ArgType::Int;
+            arg.i = static_cast<qint64>(value);
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            arg.type = ArgType::Int;
+            arg.i = value;
+        } else if constexpr (std::is_integral_v<T>) {
+            arg.type = ArgType::UInt;
+            arg.u = value;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            arg.type = ArgType::Double;
+            arg.d = value;
+        } else if constexpr (std::is_same_v<T, QString>) {
+            const QByteArray utf8 = value.toUtf8();
+            captureText(record, arg, utf8.constData(), static_cast<size_t>(utf8.size()));
+        } else if constexpr (std::is_same_v<T, QByteArray>) {
+            captureText(record, arg, value.constData(), static_cast<size_t>(value.size()));
+        } else if constexpr (std::is_same_v<T, std::string>) {
+            captureText(record, arg, value.data(), value.size());
+        } else {
+            static_assert(std::is_convertible_v<T, const char*>, "Unsupported log argument type");
+            const char* text = value;
+            captureText(record, arg, text ? text : "(null)", text ? std::strlen(text) : 6);
+        }
+    }
+
+    static void captureText(Record& record, Arg& arg, const char* text, size_t length);
+
+    void push(const Record& record);
+    bool pop(Record& record);
+    void run();
+    void write(const Record& record) const;
+
+    // Bounded MPMC queue (Vyukov): one sequence number per cell
+    static const size_t kCapacity = 4096;
+    std::unique_ptr<Cell[]> m_cells;
+    alignas(64) std::atomic<size_t> m_enqueuePos;
+    alignas(64) std::atomic<size_t> m_dequeuePos;
+    std::atomic<qint64> m_dropped;
+
+    // Drain thread
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_drained;
+    std::atomic<bool> m_sleeping;
+    std::atomic<bool> m_running;
+    std::atomic<quint64> m_written;
+    std::thread m_thread;
+};
+
+#define BLAZESTUDIO_LOG(level, category, ...) \
+    do { \
+        if constexpr (static_cast<int>(level) >= BLAZESTUDIO_LOG_LEVEL) { \
+            static LogSite logSite_(level, category); \
+            if (logSite_.admit()) { \
+                Logger::instance().log(logSite_, __VA_ARGS__); \
+            } \
+        } \
+    } while (0)
+
+/**
+ * Usage: LOG_DEBUG("VideoGLWidget", "Skipping frames from %1 to %2", from, to);
+ * prints "[VideoGLWidget] Skipping frames from 10 to 20".
+ */
+#define LOG_TRACE(category, ...) BLAZESTUDIO_LOG(LogLevel::Trace, category, __VA_ARGS__)
+#define LOG_DEBUG(category, ...) BLAZESTUDIO_LOG(LogLevel::Debug, category, __VA_ARGS__)
+#define LOG_INFO(category, ...) BLAZESTUDIO_LOG(LogLevel::Info, category, __VA_ARGS__)
+#define LOG_WARNING(category, ...) BLAZESTUDIO_LOG(LogLevel::Warning, category, __VA_ARGS__)
+#define LOG_ERROR(category, ...) BLAZESTUDIO_LOG(LogLevel::Error, category, __VA_ARGS__)
+
+#endif // LOGGER_H
@@ -0,0 +1,90 @@
+#ifndef MEDIACLOCK_H
+#define MEDIACLOCK_H
+
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+/**
+ * @brief Playback clock interpolated between audio position reports
+ *
+ * QMediaPlayer::position() only advances in coarse steps, so using it
+ * directly makes frame selection jitter. The clock instead runs from a
+ * monotonic timer anchored at the last correction. With an audio source,
+ * every new position report is compared against it: small errors are
+ * removed by running slightly fast or slow (slewing), so the clock never
+ * jumps; only errors above a threshold (seeks, audio stalls) re-anchor it.
+ * Without audio (silent videos, no output device) it simply free-runs.
+ */
+class MediaClock
+{
+public:
+    enum class Source {
+        FreeRun, // Timer only
+        Audio    // Timer corrected by audio position reports
+    };
+
+    MediaClock();
+
+    void setSource(Source source);
+    Source source() const;
+
+    /**
+     * @brief Starts running from a position
+     */
+    void start(double positionMs);
+
+    /**
+     * @brief Stops at the current position
+     */
+    void pause();
+
+    /**
+     * @brief Jumps to a position, running or not
+     */
+    void seek(double positionMs);
+
+    bool isRunning() const;
+
+    /**
+     * @brief Sets the playback rate (1.0 = real time), continuing from the current position
+     */
+    void setRate(double rate);
+    double rate() const;
+
+    /**
+     * @brief Feeds the audio position; call as often as convenient
+     *
+     * Repeated identical reports are ignored, only a changed value is a
+     * new measurement. Ignored unless the source is Audio and running.
+     */
+    void updateAudio(qint64 audioPositionMs);
+
+    /**
+     * @brief Current media position in milliseconds
+     */
+    double nowMs() const;
+
+    /**
+     * @brief Last measured audio position minus the clock (positive: clock behind audio)
+     */
+    double driftMs() const;
+
+private:
+    void anchor(double positionMs);
+    double elapsedSinceAnchorMs() const;
+
+    QElapsedTimer m_timer;
+    Source m_source;
+    bool m_running;
+    double m_rate;
+
+    double m_anchorMs;     // Media position at the anchor
+    qint64 m_anchorNs;     // Timer value at the anchor
+    double m_slew;         // Relative speed correction, e.g. 0.01 = 1% fast
+    double m_filteredErrorMs;
+    double m_driftMs;
+    qint64 m_lastAudioMs;  // Last report, to detect a new measurement
+    qint64 m_settleUntilNs; // Reports before this are ignored (after start/seek)
+};
+
+#endif // MEDIACLOCK_H
@@ -0,0 +1,114 @@
+#ifndef MEMORYACCOUNTANT_H
+#define MEMORYACCOUNTANT_H
+
+#include <QtGlobal>
+#include <atomic>
+
+class MetricGauge;
+
+/**
+ * @brief Parts of the application memory is attributed to
+ */
+enum class MemorySubsystem : int {
+    DecoderBuffers = 0, // Decoded and converted frames held for display
+    FramePools,         // Frame slots shared with out-of-process plugins
+    Caches,             // Label bitmaps, plugin checkpoints
+    PluginScratch,      // Proxy pyramid, plugin buffers charged via IPluginHost
+    InferenceArenas,    // Model runtime arenas
+    Count
+};
+
+/**
+ * @brief Process-wide accounting of large allocations against a budget
+ *
+ * Owners report the bytes they hold (usually through MemoryCharge); the
+ * accountant keeps current and peak figures per subsystem and publishes them
+ * to MetricsRegistry as memory.<subsystem>.current_bytes / peak_bytes.
+ *
+ * The budget is not enforced by failing allocations. Owners of discardable
+ * memory poll it instead: caches shrink once shouldEvict() reports the total
+ * is close to the budget, and speculative work backs off on shouldThrottle().
+ * The budget comes from BLAZESTUDIO_MEMORY_BUDGET_MB (default 4096, 0 for
+ * none).
+ */
+class MemoryAccountant
+{
+public:
+    static MemoryAccountant& instance();
+
+    /**
+     * @brief Adjusts the bytes held by a subsystem (any thread)
+     * @param delta Bytes allocated (positive) or released (negative)
+     */
+    void add(MemorySubsystem subsystem, qint64 delta);
+
+    qint64 current(MemorySubsystem subsystem) const;
+    qint64 peak(MemorySubsystem subsystem) const;
+    qint64 total() const;
+    qint64 peakTotal() const;
+
+    /**
+     * @brief Sets the budget in bytes, 0 for no budget
+     */
+    void setBudget(qint64 bytes);
+    qint64 budget() const;
+
+    /**
+     * @brief Whether caches should give memory back (total above 80% of the budget)
+     */
+    bool shouldEvict() const;
+
+    /**
+     * @brief Whether speculative work should be skipped (total above 90% of the budget)
+     */
+    bool shouldThrottle() const;
+
+    static const char* subsystemName(MemorySubsystem subsystem);
+
+private:
+    MemoryAccountant();
+
+    bool above(double fraction) const;
+    static void raisePeak(std::atomic<qint64>& peak, qint64 value);
+
+    static const int kSubsystemCount = static_cast<int>(MemorySubsystem::Count);
+
+    std::atomic<qint64> m_current[kSubsystemCount];
+    std::atomic<qint64> m_peak[kSubsystemCount];
+    std::atomic<qint64> m_total;
+    std::atomic<qint64> m_peakTotal;
+    std::atomic<qint64> m_budget;
+    std::atomic<bool> m_overBudget; // Warns once per excursion
+
+    MetricGauge* m_currentGauges[kSubsystemCount];
+    MetricGauge* m_peakGauges[kSubsystemCount];
+    MetricGauge* m_totalGauge;
+    MetricGauge* m_peakTotalGauge;
+    MetricGauge* m_budgetGauge;
+};
+
+/**
+ * @brief Bytes held by one owner, charged to a subsystem
+ *
+ * set() reports the new size and only the difference reaches the
+ * accountant; whatever is still charged is released on destruction.
+ * Not thread safe, like the buffers it describes.
+ */
+class MemoryCharge
+{
+public:
+    explicit MemoryCharge(MemorySubsystem subsystem);
+    ~MemoryCharge();
+
+    MemoryCharge(const MemoryCharge&) = delete;
+    MemoryCharge& operator=(const MemoryCharge&) = delete;
+
+    void set(qint64 bytes);
+    qint64 bytes() const;
+
+private:
+    MemorySubsystem m_subsystem;
+    qint64 m_bytes;
+};
+
+#endif // MEMORYACCOUNTANT_H
@@ -0,0 +1,43 @@
+#ifndef METRICSDUMPER_H
+#define METRICSDUMPER_H
+
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+/**
+ * @brief Appends metric snapshots to a file at a fixed interval
+ *
+ * One JSON object per line ({"time": ..., "metrics": {...}}), flushed after
+ * every line so an unattended run leaves usable data even if it is killed.
+ * Enabled at startup with BLAZESTUDIO_METRICS_FILE (and optionally
+ * BLAZESTUDIO_METRICS_INTERVAL_MS, default 1000).
+ */
+class MetricsDumper : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsDumper(QObject *parent = nullptr);
+    ~MetricsDumper();
+
+    /**
+     * @brief Starts dumping, appending to the file
+     * @return false if the file cannot be opened
+     */
+    bool start(const QString& path, int intervalMs);
+
+    void stop();
+
+    bool isRunning() const;
+
+private slots:
+    void dump();
+
+private:
+    QFile m_file;
+    QTimer m_timer;
+};
+
+#endif // METRICSDUMPER_H
@@ -0,0 +1,184 @@
+#ifndef METRICSREGISTRY_H
+#define METRICSREGISTRY_H
+
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Well-known metric names
+ *
+ * Counters only go up; rates (fps) are derived from two snapshots.
+ */
+namespace MetricNames {
+inline const QString FramesDecoded = QStringLiteral("video.frames_decoded");       // Counter
+inline const QString FramesPresented = QStringLiteral("video.frames_presented");   // Counter
+inline const QString FramesDropped = QStringLiteral("video.frames_dropped");       // Counter, never shown
+inline const QString PresentLagMs = QStringLiteral("video.present_lag_ms");        // Gauge, clock minus shown PTS
+inline const QString AvDriftMs = QStringLiteral("av.drift_ms");                    // Gauge, audio minus clock
+inline const QString FramesProcessed = QStringLiteral("plugins.frames_processed"); // Counter
+inline const QString FrameClones = QStringLiteral("plugins.frame_clones");         // Counter, copy-on-write copies
+inline const QString Checkpoints = QStringLiteral("plugins.checkpoints");          // Gauge, stored checkpoints
+inline const QString LogQueueDepth = QStringLiteral("logger.queue_depth");         // Gauge
+inline const QString LogDropped = QStringLiteral("logger.dropped");                // Gauge
+inline const QString ResidentBytes = QStringLiteral("process.rss_bytes");          // Gauge
+inline const QString MemoryTotal = QStringLiteral("memory.total.current_bytes");    // Gauge, accounted bytes
+inline const QString MemoryPeak = QStringLiteral("memory.total.peak_bytes");        // Gauge
+inline const QString MemoryBudget = QStringLiteral("memory.budget_bytes");          // Gauge, 0 = none
+
+/**
+ * @brief Per-view name of a metric, e.g. "grid0/video.frames_decoded"
+ *
+ * Views and their plugin managers count under their own scope so that
+ * several views playing at once don't add up into one rate. Scopes are
+ * reused across loads; the registry keeps every name it has handed out.
+ */
+inline QString scoped(const QString& scope, const QString& name)
+{
+    return scope.isEmpty() ? name : scope + QLatin1Char('/') + name;
+}
+} // namespace MetricNames
+
+enum class MetricKind {
+    Counter,
+    Gauge
+};
+
+/**
+ * @brief Monotonic counter; add() is one relaxed atomic add
+ */
+class MetricCounter
+{
+public:
+    void add(qint64 delta = 1)
+    {
+        m_value.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    qint64 value() const
+    {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<qint64> m_value{0};
+};
+
+/**
+ * @brief Last-value gauge; set() is one relaxed atomic store
+ */
+class MetricGauge
+{
+public:
+    void set(double value)
+    {
+        m_value.store(value, std::memory_order_relaxed);
+    }
+
+    double value() const
+    {
+        return m_value.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<double> m_value{0.0};
+};
+
+/**
+ * @brief Values of all metrics at one instant
+ */
+class MetricsSnapshot
+{
+public:
+    struct Value
+    {
+        const QString* name; // Owned by the registry, valid for the process lifetime
+        MetricKind kind;
+        double value;
+    };
+
+    qint64 timestampMs = 0; // Steady clock
+    std::vector<Value> values;
+
+    /**
+     * @brief Value of a metric, or fallback if it is not registered
+     */
+    double value(const QString& name, double fallback = 0.0) const;
+
+    /**
+     * @brief Per-second rate of a counter between an earlier snapshot and this one
+     */
+    double rate(const QString& name, const MetricsSnapshot& earlier) const;
+
+    QJsonObject toJson() const;
+};
+
+/**
+ * @brief Process-wide registry of named counters and gauges
+ *
+ * Registration takes a lock and is meant to happen once per call site
+ * (keep the returned reference). Updates are single relaxed atomics, and
+ * snapshot() never blocks writers: metrics live in a fixed array published
+ * through an atomic count, so a snapshot is one pass over plain values.
+ */
+class MetricsRegistry
+{
+public:
+    static MetricsRegistry& instance();
+
+    /**
+     * @brief Counter with this name, created on first use
+     */
+    MetricCounter& counter(const QString& name);
+
+    /**
+     * @brief Gauge with this name, created on first use
+     */
+    MetricGauge& gauge(const QString& name);
+
+    /**
+     * @brief Copies all current values (any thread)
+     */
+    MetricsSnapshot snapshot() const;
+
+    /**
+     * @brief Refreshes process gauges (RSS); cheap to call often, samples at most every 500 ms
+     */
+    void sampleProcess();
+
+    /**
+     * @brief Resident set size of this process, 0 if unknown
+     */
+    static qint64 residentBytes();
+
+private:
+    MetricsRegistry();
+
+    struct Entry
+    {
+        QString name;
+        MetricKind kind = MetricKind::Counter;
+        MetricCounter counter;
+        MetricGauge gauge;
+    };
+
+    Entry& entry(const QString& name, MetricKind kind);
+
+    static const int kMaxMetrics = 256;
+
+    std::unique_ptr<Entry[]> m_entries;
+    std::atomic<int> m_count;
+    Entry m_overflow; // Handed out once the array is full
+
+    QMutex m_mutex; // Registration only
+    QHash<QString, int> m_index;
+
+    std::atomic<qint64> m_lastProcessSampleMs;
+};
+
+#endif // METRICSREGISTRY_H
@@ -0,0 +1,105 @@
+#ifndef OVERLAYCOMMANDLIST_H
+#define OVERLAYCOMMANDLIST_H
+
+#include <QColor>
+#include <QString>
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * @brief Single vector overlay primitive
+ *
+ * Frame space coordinates are stored normalized (0.0 - 1.0) to the canvas
+ * the plugin was drawing on, so the renderer can map them to any display
+ * size. Screen space coordinates are logical widget pixels measured from the
+ * video rectangle corner selected by the anchor.
+ */
+struct OverlayCommand
+{
+    enum class Type {
+        Line,
+        Circle,
+        Rect,
+        Text
+    };
+
+    enum class Space {
+        Frame,  // Follows the video image (skeletons, boxes)
+        Screen  // Fixed size on screen (HUD text)
+    };
+
+    Type type = Type::Line;
+    Space space = Space::Frame;
+
+    cv::Point2f p1;         // Line start, circle center, rect top-left, text anchor
+    cv::Point2f p2;         // Line end, rect bottom-right
+    float radius = 0.0f;    // Circle radius (normalized to canvas width in frame space)
+    float thickness = 1.0f; // Stroke width in screen pixels
+    bool filled = false;
+
+    QColor color;
+    QColor background;      // Text background (invalid = none)
+    QString text;
+    float fontSize = 14.0f; // Normalized to canvas height in frame space
+    Qt::Alignment anchor = Qt::AlignLeft | Qt::AlignTop;
+};
+
+/**
+ * @brief Per-frame list of overlay primitives
+ *
+ * Plugins emit primitives here instead of rasterizing them into the frame.
+ * The video widget renders the whole list on top of the frame texture in a
+ * single batched draw, so overlays cost nothing at source resolution and can
+ * be toggled without reprocessing the frame.
+ */
+class OverlayCommandList
+{
+public:
+    OverlayCommandList();
+
+    /**
+     * @brief Sets the size of the frame subsequent frame space commands refer to
+     * @param size Frame size in pixels
+     */
+    void setCanvasSize(const cv::Size& size);
+    cv::Size canvasSize() const;
+
+    void addLine(const cv::Point2f& from, const cv::Point2f& to, const QColor& color,
+                 float thickness = 1.0f,
+                 OverlayCommand::Space space = OverlayCommand::Space::Frame);
+
+    void addCircle(const cv::Point2f& center, float radius, const QColor& color,
+                   float thickness = 1.0f, bool filled = false,
+                   OverlayCommand::Space space = OverlayCommand::Space::Frame);
+
+    void addRect(const cv::Rect2f& rect, const QColor& color,
+                 float thickness = 1.0f, bool filled = false,
+                 OverlayCommand::Space space = OverlayCommand::Space::Frame);
+
+    /**
+     * @brief Adds a text label
+     * @param position Corner of the label box selected by anchor
+     * @param fontSize Font pixel size (frame pixels in frame space)
+     * @param background Box color behind the text (invalid = no box)
+     * @param anchor Which corner of the label box (and, in screen space,
+     *               of the video rectangle) the position refers to
+     */
+    void addText(const QString& text, const cv::Point2f& position, const QColor& color,
+                 float fontSize = 14.0f, const QColor& background = QColor(),
+                 Qt::Alignment anchor = Qt::AlignLeft | Qt::AlignTop,
+                 OverlayCommand::Space space = OverlayCommand::Space::Frame);
+
+    void clear();
+    bool isEmpty() const;
+    void swap(OverlayCommandList& other);
+
+    const std::vector<OverlayCommand>& commands() const;
+
+private:
+    cv::Point2f normalize(const cv::Point2f& point, OverlayCommand::Space space) const;
+
+    std::vector<OverlayCommand> m_commands;
+    cv::Size m_canvasSize;
+};
+
+#endif // OVERLAYCOMMANDLIST_H
@@ -0,0 +1,81 @@
+#ifndef PLUGINCHECKPOINTSTORE_H
+#define PLUGINCHECKPOINTSTORE_H
+
+#include "memoryaccountant.h"
+#include <QMutex>
+#include <QString>
+#include <QVariant>
+#include <deque>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Plugin states captured after one frame
+ */
+struct PluginCheckpoint
+{
+    qint64 frameIndex = 0;
+    qint64 timestamp = 0; // Milliseconds
+    std::vector<std::pair<QString, QVariant>> states; // Plugin name, state
+};
+
+/**
+ * @brief Bounded in-memory store of plugin checkpoints
+ *
+ * Checkpoints are indexed by timestamp. When full, the checkpoint inserted
+ * first is dropped, so memory stays bounded however long the session. Their
+ * approximate size is charged to MemorySubsystem::Caches, and while the
+ * memory budget is under pressure the store keeps a quarter of its capacity.
+ * Inserted by the processing thread and looked up on seeks from the UI
+ * thread; both only hold the lock for a map operation.
+ */
+class PluginCheckpointStore
+{
+public:
+    explicit PluginCheckpointStore(int capacity = 256);
+
+    /**
+     * @brief Adds a checkpoint, replacing one at the same timestamp
+     */
+    void insert(std::shared_ptr<const PluginCheckpoint> checkpoint);
+
+    /**
+     * @brief Latest checkpoint at or before a position
+     * @param timestamp Seek target in milliseconds
+     * @param maxDistanceMs Oldest checkpoint still worth restoring
+     * @return Checkpoint, or nullptr if none is close enough
+     */
+    std::shared_ptr<const PluginCheckpoint> nearest(qint64 timestamp, qint64 maxDistanceMs) const;
+
+    bool contains(qint64 timestamp) const;
+
+    void setCapacity(int capacity);
+    int capacity() const;
+    int size() const;
+    void clear();
+
+    /**
+     * @brief Drops the oldest checkpoints if the memory budget is under pressure
+     */
+    void trim();
+
+    /**
+     * @brief Estimated memory held by the stored checkpoints
+     */
+    qint64 approximateBytes() const;
+
+private:
+    void evictLocked();
+    static qint64 approximateBytes(const PluginCheckpoint& checkpoint);
+
+    mutable QMutex m_mutex;
+    std::map<qint64, std::shared_ptr<const PluginCheckpoint>> m_checkpoints;
+    std::deque<qint64> m_insertionOrder;
+    int m_capacity;
+    qint64 m_bytes;
+    MemoryCharge m_charge;
+};
+
+#endif // PLUGINCHECKPOINTSTORE_H
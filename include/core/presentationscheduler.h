@@ -0,0 +1,87 @@
+#ifndef PRESENTATIONSCHEDULER_H
+#define PRESENTATIONSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QtGlobal>
+
+/**
+ * @brief Presentation timing statistics since the last reset
+ */
+struct PresentationStats
+{
+    qint64 vsyncCount = 0;       // Buffer swaps observed while playing
+    qint64 presentedFrames = 0;  // Swaps that showed a new frame
+    qint64 repeatedVsyncs = 0;   // Swaps that repeated the previous frame
+    qint64 skippedFrames = 0;    // Frames decoded past without being shown
+
+    double meanSwapIntervalMs = 0.0;
+    double swapJitterMs = 0.0;   // Standard deviation of the swap interval
+    double maxSwapIntervalMs = 0.0;
+
+    double meanAbsPtsErrorMs = 0.0; // |frame PTS - media clock| at display time
+    double maxAbsPtsErrorMs = 0.0;
+};
+
+/**
+ * @brief Chooses which frame to show on each vsync
+ *
+ * Driven by QOpenGLWidget::frameSwapped instead of a polling timer, so
+ * presentation is phase-locked to the display. For every swap it picks the
+ * frame whose presentation timestamp is closest to the media clock at the
+ * moment the next swap becomes visible, and records jitter statistics.
+ * The caller maps that time to a frame through its TimestampIndex.
+ */
+class PresentationScheduler
+{
+public:
+    PresentationScheduler();
+
+    /**
+     * @brief Starts a new playback session
+     * @param refreshRateHz Nominal display refresh rate (initial vsync estimate)
+     */
+    void reset(double refreshRateHz);
+
+    /**
+     * @brief Records a buffer swap (call from frameSwapped)
+     */
+    void onVsync();
+
+    /**
+     * @brief Media time at which a frame submitted now becomes visible
+     * @param clockMs Current media clock in milliseconds
+     * @param rate Playback rate, media time advanced per wall-clock time
+     */
+    double displayTimeMs(double clockMs, double rate = 1.0) const;
+
+    /**
+     * @brief Records that a new frame was shown
+     * @param ptsMs Presentation timestamp of the shown frame
+     * @param displayTimeMs Media time it was meant for
+     * @param skippedFrames Frames passed over to reach it
+     */
+    void recordPresented(double ptsMs, double displayTimeMs, qint64 skippedFrames);
+
+    /**
+     * @brief Records a swap that kept the previous frame on screen
+     */
+    void recordRepeated();
+
+    PresentationStats stats() const;
+
+private:
+    QElapsedTimer m_timer;
+    qint64 m_lastVsyncNs;
+    double m_vsyncIntervalMs;
+
+    PresentationStats m_stats;
+
+    // Running variance of the swap interval (Welford)
+    qint64 m_intervalCount;
+    double m_intervalMean;
+    double m_intervalM2;
+
+    double m_ptsErrorSum;
+};
+
+#endif // PRESENTATIONSCHEDULER_H
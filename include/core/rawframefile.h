@@ -0,0 +1,143 @@
+#ifndef RAWFRAMEFILE_H
+#define RAWFRAMEFILE_H
+
+#include <QFile>
+#include <QString>
+#include <QtGlobal>
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * @brief Fixed header at the start of a raw frame file
+ *
+ * Layout, all offsets aligned to kAlignment so every frame slot can be
+ * used in place from a memory mapping:
+ *
+ *   [header][frame 0][frame 1]...[frame N-1][index]
+ *
+ * The index holds one RawFrameIndexEntry per frame. It comes last because
+ * the number of frames is only known when the capture ends.
+ */
+struct RawFrameFileHeader
+{
+    static const quint32 kVersion = 1;
+    static const quint64 kAlignment = 4096;
+
+    enum ColorOrder : quint32 {
+        BGR = 0, // As decoded by OpenCV
+        RGB = 1  // As seen by plugins
+    };
+
+    char magic[8];           // "BSRAWFRM"
+    quint32 version;
+    quint32 colorOrder;
+    qint32 rows;
+    qint32 cols;
+    qint32 type;             // OpenCV matrix type
+    quint32 reserved;
+    quint64 step;            // Bytes per row inside a slot
+    quint64 slotBytes;       // Frame slot size, a multiple of kAlignment
+    quint64 frameCount;
+    quint64 dataOffset;      // First frame slot
+    quint64 indexOffset;     // RawFrameIndexEntry[frameCount]
+    double fps;
+};
+
+/**
+ * @brief Timing of one captured frame
+ */
+struct RawFrameIndexEntry
+{
+    qint64 timestamp;  // Milliseconds
+    qint64 frameIndex; // Index in the source video
+};
+
+/**
+ * @brief Writes decoded frames into a raw frame file
+ *
+ * All frames must have the size and type of the first one. Frames are
+ * appended with plain sequential writes; the index and the final header
+ * are written by close().
+ */
+class RawFrameWriter
+{
+public:
+    RawFrameWriter();
+    ~RawFrameWriter();
+
+    RawFrameWriter(const RawFrameWriter&) = delete;
+    RawFrameWriter& operator=(const RawFrameWriter&) = delete;
+
+    /**
+     * @brief Creates the file; the frame format is taken from the first frame
+     * @param path Output file
+     * @param fps Source frame rate, stored for replay pacing
+     * @param colorOrder Channel order of the frames that will be appended
+     */
+    bool open(const QString& path, double fps, RawFrameFileHeader::ColorOrder colorOrder);
+
+    /**
+     * @brief Appends one frame
+     * @return false if the frame does not match the file format or on I/O errors
+     */
+    bool append(const cv::Mat& frame, qint64 timestamp, qint64 frameIndex);
+
+    /**
+     * @brief Writes the index and header and closes the file
+     */
+    bool close();
+
+    bool isOpen() const;
+    qint64 frameCount() const;
+    QString path() const;
+
+private:
+    QFile m_file;
+    RawFrameFileHeader m_header;
+    std::vector<RawFrameIndexEntry> m_index;
+    std::vector<char> m_padding; // Zeros to fill slots up to slotBytes
+};
+
+/**
+ * @brief Read-only access to a raw frame file through a memory mapping
+ *
+ * The file is mapped private (copy-on-write): frames are handed out as
+ * cv::Mat headers on the mapping without any copy, and writing into them
+ * never changes the file. Frames stay valid until close().
+ */
+class RawFrameReader
+{
+public:
+    RawFrameReader();
+    ~RawFrameReader();
+
+    RawFrameReader(const RawFrameReader&) = delete;
+    RawFrameReader& operator=(const RawFrameReader&) = delete;
+
+    bool open(const QString& path);
+    void close();
+
+    bool isOpen() const;
+    qint64 frameCount() const;
+    cv::Size frameSize() const;
+    int frameType() const;
+    double fps() const;
+    RawFrameFileHeader::ColorOrder colorOrder() const;
+
+    /**
+     * @brief Frame i, pointing into the mapping
+     */
+    cv::Mat frame(qint64 i) const;
+
+    qint64 timestamp(qint64 i) const;
+    qint64 frameIndex(qint64 i) const;
+
+private:
+    QFile m_file;
+    uchar* m_data;
+    qint64 m_size;
+    const RawFrameFileHeader* m_header;
+    const RawFrameIndexEntry* m_index;
+};
+
+#endif // RAWFRAMEFILE_H
@@ -0,0 +1,63 @@
+#ifndef RAWFRAMEREPLAY_H
+#define RAWFRAMEREPLAY_H
+
+#include "latencyhistogram.h"
+#include "overlaycommandlist.h"
+#include "rawframefile.h"
+#include <opencv2/core.hpp>
+
+class VideoPluginManager;
+
+/**
+ * @brief Result of a replay run
+ */
+struct RawReplayStats
+{
+    qint64 frames = 0;
+    double elapsedMs = 0.0;          // Wall time, frame copies included
+    double framesPerSecond = 0.0;
+    LatencyStats processLatency;     // VideoPluginManager::processFrame only
+};
+
+/**
+ * @brief Feeds captured frames straight into a plugin chain
+ *
+ * No decoder and no clock: frames come from the mapping as fast as the
+ * chain takes them, so plugin timings are not mixed with decode cost or
+ * audio pacing and are the same on every machine with the same file.
+ * Each frame is copied into a reusable buffer first (at memory bandwidth)
+ * so plugins writing into it cannot change the next loop's input; BGR
+ * captures are converted to RGB in that same pass.
+ */
+class RawFrameReplay
+{
+public:
+    explicit RawFrameReplay(const RawFrameReader& reader);
+
+    /**
+     * @brief Runs every frame through the manager
+     * @param manager Manager with its plugins initialized for the file's format
+     * @param loops Number of passes over the file
+     */
+    RawReplayStats run(VideoPluginManager& manager, int loops = 1);
+
+    /**
+     * @brief Copies a frame into the work buffer, for callers timing process() alone
+     * @param index Frame of the file, wrapped around its frame count
+     */
+    void load(qint64 index);
+
+    /**
+     * @brief Runs the loaded frame through the manager at full resolution
+     * @param index Same index as passed to load()
+     */
+    void process(VideoPluginManager& manager, qint64 index);
+
+private:
+    const RawFrameReader& m_reader;
+    bool m_convert;
+    cv::Mat m_work;
+    OverlayCommandList m_overlay;
+};
+
+#endif // RAWFRAMEREPLAY_H
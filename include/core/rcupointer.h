@@ -0,0 +1,175 @@
+#ifndef RCUPOINTER_H
+#define RCUPOINTER_H
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Read-copy-update pointer to an immutable object
+ *
+ * Readers (frame processing) take a ReadGuard, which costs two atomic
+ * increments and never blocks or waits on a writer. Writers build a new
+ * object and publish() it; the previous one is retired and freed by
+ * reclaim() once every reader that could still see it has left.
+ *
+ * Grace periods use two reader counters selected by the parity of an
+ * epoch. A reader registers in the counter of the current epoch and then
+ * re-checks the epoch, so a reader counted in a slot saw that slot's epoch
+ * after registering. reclaim() flips the epoch and frees a retired batch
+ * only when the counter of the previous epoch drains to zero; it never
+ * waits, unfinished batches are simply checked again on the next call.
+ *
+ * Writers must be serialized by the caller.
+ */
+template<typename T>
+class RcuPointer
+{
+public:
+    class ReadGuard
+    {
+    public:
+        explicit ReadGuard(const RcuPointer& owner)
+            : m_owner(owner)
+        {
+            for (;;) {
+                unsigned int epoch = owner.m_epoch.load(std::memory_order_seq_cst);
+                m_slot = epoch & 1u;
+                owner.m_readers[m_slot].fetch_add(1, std::memory_order_seq_cst);
+                if (owner.m_epoch.load(std::memory_order_seq_cst) == epoch) {
+                    break;
+                }
+                // A writer flipped the epoch in between, register again
+                owner.m_readers[m_slot].fetch_sub(1, std::memory_order_seq_cst);
+            }
+            m_pointer = owner.m_current.load(std::memory_order_seq_cst);
+        }
+
+        ~ReadGuard()
+        {
+            m_owner.m_readers[m_slot].fetch_sub(1, std::memory_order_release);
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+        const T* get() const { return m_pointer; }
+        const T* operator->() const { return m_pointer; }
+        const T& operator*() const { return *m_pointer; }
+
+    private:
+        const RcuPointer& m_owner;
+        const T* m_pointer;
+        unsigned int m_slot;
+    };
+
+    explicit RcuPointer(std::unique_ptr<T> initial = std::make_unique<T>())
+        : m_current(initial.release())
+        , m_epoch(0)
+        , m_drainingSlot(-1)
+    {
+        m_readers[0].store(0);
+        m_readers[1].store(0);
+    }
+
+    ~RcuPointer()
+    {
+        // Owners are destroyed after processing stops; wait out stragglers
+        while (m_readers[0].load() != 0 || m_readers[1].load() != 0) {
+            std::this_thread::yield();
+        }
+
+        delete m_current.load();
+        for (T* retired : m_retired) {
+            delete retired;
+        }
+        for (T* draining : m_draining) {
+            delete draining;
+        }
+    }
+
+    RcuPointer(const RcuPointer&) = delete;
+    RcuPointer& operator=(const RcuPointer&) = delete;
+
+    /**
+     * @brief Pins the current object for the lifetime of the guard (any thread)
+     */
+    ReadGuard read() const
+    {
+        return ReadGuard(*this);
+    }
+
+    /**
+     * @brief Current object as seen by the writer (writer thread only)
+     */
+    const T* writerView() const
+    {
+        return m_current.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Replaces the current object and retires the previous one (writer)
+     */
+    void publish(std::unique_ptr<T> next)
+    {
+        T* previous = m_current.exchange(next.release(), std::memory_order_seq_cst);
+        m_retired.push_back(previous);
+        reclaim();
+    }
+
+    /**
+     * @brief Frees retired objects no reader can see anymore (writer, never blocks)
+     */
+    void reclaim()
+    {
+        if (m_drainingSlot >= 0) {
+            if (m_readers[m_drainingSlot].load(std::memory_order_seq_cst) != 0) {
+                return;
+            }
+            freeDraining();
+        }
+
+        if (m_retired.empty()) {
+            return;
+        }
+
+        // Start a grace period for everything retired so far
+        m_draining.swap(m_retired);
+        unsigned int previousEpoch = m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        m_drainingSlot = static_cast<int>(previousEpoch & 1u);
+
+        if (m_readers[m_drainingSlot].load(std::memory_order_seq_cst) == 0) {
+            freeDraining();
+        }
+    }
+
+    /**
+     * @brief Number of retired objects not freed yet (writer)
+     */
+    size_t pendingReclaim() const
+    {
+        return m_retired.size() + m_draining.size();
+    }
+
+private:
+    void freeDraining()
+    {
+        for (T* draining : m_draining) {
+            delete draining;
+        }
+        m_draining.clear();
+        m_drainingSlot = -1;
+    }
+
+    std::atomic<T*> m_current;
+    std::atomic<unsigned int> m_epoch;
+    mutable std::atomic<int> m_readers[2]; // Reading is logically const
+
+    // Writer side bookkeeping
+    std::vector<T*> m_retired;   // Waiting for the next grace period
+    std::vector<T*> m_draining;  // Waiting for readers of m_drainingSlot
+    int m_drainingSlot;
+};
+
+#endif // RCUPOINTER_H
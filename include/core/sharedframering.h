@@ -0,0 +1,149 @@
+#ifndef SHAREDFRAMERING_H
+#define SHAREDFRAMERING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Control block at the start of a shared frame ring
+ *
+ * The viewer fills in a request, then bumps requestSeq; the host answers
+ * and bumps responseSeq to the same value. Both counters are also the
+ * futex words the other side sleeps on.
+ */
+struct SharedFrameHeader
+{
+    static const uint32_t kMagic = 0x42534652; // "BSFR"
+    static const uint32_t kVersion = 1;
+    static const uint32_t kPayloadCapacity = 64 * 1024;
+
+    enum Kind : uint32_t {
+        Frame = 1,    // Process the frame in `slot`
+        Command = 2,  // JSON command in `payload`
+        Shutdown = 3
+    };
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t reserved;
+    uint64_t slotBytes;
+
+    std::atomic<uint32_t> requestSeq;
+    std::atomic<uint32_t> responseSeq;
+
+    // Request, written by the viewer
+    uint32_t kind;
+    int32_t slot;
+    int32_t rows;
+    int32_t cols;
+    int32_t type;   // OpenCV matrix type
+    int32_t pad;
+    uint64_t step;
+    int64_t timestamp;
+    int64_t frameIndex;
+
+    // Response, written by the host
+    int32_t status; // 1 = success
+    int32_t modified; // 1 if the host wrote into the slot
+
+    uint32_t payloadBytes;
+    char payload[kPayloadCapacity];
+};
+
+/**
+ * @brief Frame ring in shared memory for out-of-process plugins
+ *
+ * One control block followed by page aligned frame slots, mapped by the
+ * viewer (owner) and the plugin host (client). The frame bytes are written
+ * once into a slot and processed there by the host; nothing is serialized.
+ *
+ * Platform layer:
+ * - Linux: POSIX shm (shm_open/mmap) and futex wait/wake on the sequence
+ *   counters, with a short spin first since answers usually come quickly
+ * - Windows: named file mapping and two named auto-reset events
+ * - Other POSIX systems: POSIX shm and polling with short sleeps
+ */
+class SharedFrameRing
+{
+public:
+    SharedFrameRing();
+    ~SharedFrameRing();
+
+    SharedFrameRing(const SharedFrameRing&) = delete;
+    SharedFrameRing& operator=(const SharedFrameRing&) = delete;
+
+    /**
+     * @brief Creates and maps a new ring (viewer)
+     * @param name Unique name, see uniqueName()
+     * @param slotBytes Capacity of each frame slot
+     * @param slotCount Number of slots
+     */
+    bool create(const std::string& name, size_t slotBytes, uint32_t slotCount);
+
+    /**
+     * @brief Maps an existing ring (host)
+     */
+    bool attach(const std::string& name);
+
+    /**
+     * @brief Unmaps the ring; the owner also removes it
+     */
+    void close();
+
+    bool isOpen() const;
+    const std::string& name() const;
+
+    SharedFrameHeader* header() const;
+    uint8_t* slot(uint32_t index) const;
+    size_t slotBytes() const;
+    uint32_t slotCount() const;
+
+    /**
+     * @brief Publishes the request in the header and wakes the host (viewer)
+     * @return Sequence number the response will carry
+     */
+    uint32_t postRequest();
+
+    /**
+     * @brief Waits for a request newer than lastSeen (host)
+     * @return false on timeout
+     */
+    bool waitRequest(uint32_t lastSeen, int timeoutMs);
+
+    /**
+     * @brief Marks the current request answered and wakes the viewer (host)
+     */
+    void postResponse();
+
+    /**
+     * @brief Waits until the response to a request arrived (viewer)
+     * @return false on timeout
+     */
+    bool waitResponse(uint32_t sequence, int timeoutMs);
+
+    /**
+     * @brief Name not used by any other ring of this machine
+     */
+    static std::string uniqueName();
+
+private:
+    bool map(size_t totalBytes, bool create);
+    bool openEvents(bool create);
+    void closeEvents();
+    static size_t headerBytes();
+
+    std::string m_name;
+    bool m_owner;
+    void* m_base;
+    size_t m_totalBytes;
+
+    // Platform handles (file descriptor, or mapping/event handles on Windows)
+    intptr_t m_handle;
+    intptr_t m_requestEvent;
+    intptr_t m_responseEvent;
+};
+
+#endif // SHAREDFRAMERING_H
@@ -0,0 +1,107 @@
+#ifndef TIMESTAMPINDEX_H
+#define TIMESTAMPINDEX_H
+
+#include "memoryaccountant.h"
+#include <QMutex>
+#include <QSemaphore>
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class QRunnable;
+
+/**
+ * @brief Presentation timestamp of every frame of a video
+ *
+ * Variable frame rate footage (phones) cannot be timed as index / fps: the
+ * error adds up to seconds over a long clip. The index is filled by a
+ * background job that walks the file with its own cv::VideoCapture and
+ * records CAP_PROP_POS_MSEC of every frame, 4 bytes per frame. Jobs of all
+ * indexes share one indexing thread, so a multi-view session adds a single
+ * extra decoder next to the playback ones; later files wait their turn.
+ *
+ * Lookups work at any time: frames not indexed yet are extrapolated from the
+ * last indexed one at the nominal frame rate, which is also what a file
+ * without usable timestamps falls back to. Time to frame is a binary search.
+ */
+class TimestampIndex
+{
+public:
+    TimestampIndex();
+    ~TimestampIndex();
+
+    TimestampIndex(const TimestampIndex&) = delete;
+    TimestampIndex& operator=(const TimestampIndex&) = delete;
+
+    /**
+     * @brief Starts indexing a file in the background, dropping the previous index
+     * @param nominalFps Container frame rate, used until frames are indexed
+     * @param nominalFrameCount Container frame count, 0 if unknown
+     */
+    void build(const QString& videoPath, double nominalFps, qint64 nominalFrameCount);
+
+    /**
+     * @brief Stops a build in progress, keeping what was indexed
+     */
+    void cancel();
+
+    /**
+     * @brief Whether every frame of the file is indexed
+     */
+    bool isComplete() const;
+
+    /**
+     * @brief Number of frames indexed so far
+     */
+    qint64 indexedFrames() const;
+
+    /**
+     * @brief Frame count, nominal until the index is complete
+     */
+    qint64 frameCount() const;
+
+    /**
+     * @brief Presentation timestamp of a frame in milliseconds (first frame at 0)
+     */
+    qint64 ptsMs(qint64 frameIndex) const;
+
+    /**
+     * @brief Frame on screen at a time: the last one whose PTS is not after it
+     */
+    qint64 frameAt(qint64 timeMs) const;
+
+    /**
+     * @brief Frame whose PTS is nearest to a time
+     */
+    qint64 nearestFrame(double timeMs) const;
+
+    /**
+     * @brief End of the last frame in milliseconds, nominal until the index is complete
+     */
+    qint64 durationMs() const;
+
+private:
+    void run(const QString& videoPath);
+    void append(const std::vector<qint32>& chunk);
+
+    double frameIntervalMs() const;
+    qint64 extrapolatedPtsLocked(qint64 frameIndex) const;
+    qint64 frameAtLocked(double timeMs) const;
+    qint64 clampFrameLocked(qint64 frameIndex) const;
+    qint64 lastFrameLocked() const; // -1 if unknown
+
+    mutable QMutex m_mutex;
+    std::vector<qint32> m_pts; // Milliseconds from the first frame, strictly increasing
+    double m_nominalFps;
+    qint64 m_nominalFrameCount;
+    MemoryCharge m_charge;
+
+    std::unique_ptr<QRunnable> m_job; // Queued or running on the indexing pool
+    QSemaphore m_jobDone; // Released when a job that started has returned
+    std::atomic<bool> m_cancel;
+    std::atomic<bool> m_complete;
+};
+
+#endif // TIMESTAMPINDEX_H
@@ -0,0 +1,146 @@
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * @brief Per-frame pipeline tracer exporting Chrome trace JSON
+ *
+ * Records begin/end events of pipeline stages (decode, convert, each
+ * plugin, upload, paint), tagged with the frame index, so a late frame can
+ * be inspected in chrome://tracing or ui.perfetto.dev.
+ *
+ * Every thread writes into its own fixed-size buffer: recording is a clock
+ * read and a store, without locks or allocation. A buffer that fills up
+ * drops further events and counts them. While tracing is off a scope costs
+ * one relaxed atomic load; defining BLAZESTUDIO_NO_TRACING removes the
+ * macros entirely.
+ *
+ * Event names must outlive the trace: use string literals, or intern()
+ * for names built at runtime.
+ */
+class Tracer
+{
+public:
+    enum class Phase : char {
+        Begin = 'B',
+        End = 'E',
+        Instant = 'i'
+    };
+
+    /**
+     * @brief Whether events are being recorded (any thread)
+     */
+    static bool isEnabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Drops the previous trace and starts recording
+     */
+    static void start();
+
+    /**
+     * @brief Stops recording; the trace is kept until the next start()
+     */
+    static void stop();
+
+    /**
+     * @brief Records one event on the calling thread's buffer
+     * @param phase Begin, End or Instant
+     * @param name Stage name, must stay valid (see intern())
+     * @param frameIndex Frame the stage worked on, or -1
+     */
+    static void record(Phase phase, const char* name, qint64 frameIndex);
+
+    /**
+     * @brief Stable copy of a runtime name, kept for the process lifetime
+     *
+     * Not for the hot path: it takes a lock. Call it when the name is
+     * created (e.g. when the plugin chain is built).
+     */
+    static const char* intern(const QString& name);
+
+    /**
+     * @brief Names the calling thread in the trace
+     *
+     * Cheap while tracing is off: the thread's buffer is only allocated
+     * when it records its first event.
+     */
+    static void setThreadName(const QString& name);
+
+    /**
+     * @brief Writes the recorded events in Chrome trace event format
+     * @param path Output file
+     * @return false if the file could not be written
+     */
+    static bool writeChromeTrace(const QString& path);
+
+    /**
+     * @brief Number of recorded events of the current trace
+     */
+    static qint64 eventCount();
+
+    /**
+     * @brief Events lost to full thread buffers in the current trace
+     */
+    static qint64 droppedEvents();
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+ * @brief Records a Begin event now and the matching End event on scope exit
+ *
+ * The End event is written even if tracing was stopped in between, so
+ * every recorded Begin is closed.
+ */
+class TraceScope
+{
+public:
+    TraceScope(const char* name, qint64 frameIndex)
+        : m_name(Tracer::isEnabled() ? name : nullptr)
+        , m_frameIndex(frameIndex)
+    {
+        if (m_name) {
+            Tracer::record(Tracer::Phase::Begin, m_name, m_frameIndex);
+        }
+    }
+
+    ~TraceScope()
+    {
+        if (m_name) {
+            Tracer::record(Tracer::Phase::End, m_name, m_frameIndex);
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name;
+    qint64 m_frameIndex;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifndef BLAZESTUDIO_NO_TRACING
+#define TRACE_SCOPE(name, frameIndex) \
+    TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name, frameIndex)
+#define TRACE_INSTANT(name, frameIndex) \
+    do { \
+        if (Tracer::isEnabled()) { \
+            Tracer::record(Tracer::Phase::Instant, name, frameIndex); \
+        } \
+    } while (0)
+#else
+#define TRACE_SCOPE(name, frameIndex) do { } while (0)
+#define TRACE_INSTANT(name, frameIndex) do { } while (0)
+#endif
+
+#endif // TRACING_H
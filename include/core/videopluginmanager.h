@@ -2,11 +2,35 @@
 #define VIDEOPLUGINMANAGER_H
 
 #include "ivideoplugin.h"
+#include "overlaycommandlist.h"
+#include "framepyramid.h"
+#include "framecontext.h"
+#include "latencyhistogram.h"
+#include "metricsregistry.h"
+#include "plugincheckpointstore.h"
+#include "rcupointer.h"
 #include <QObject>
+#include <QMutex>
 #include <QList>
+#include <QStringList>
+#include <atomic>
 #include <memory>
+#include <vector>
 #include <opencv2/opencv.hpp>
 
+class QPluginLoader;
+
+/**
+ * @brief Latency of one plugin's processFrame calls
+ */
+struct PluginLatency
+{
+    QString name;
+    bool enabled = false;
+    LatencyStats stats;
+    QString status; // The plugin's "status" setting, if any
+};
+
 /**
  * @brief Video plugin manager
  * 
@@ -15,14 +39,28 @@
  * 
  * Design for performance:
  * - Optimized sequential processing
- * - Enabled plugins cache
+ * - Enabled plugins published as an immutable, priority-sorted chain
  * - Conditional execution based on state
+ *
+ * Threading: plugin list mutations happen on the UI thread and publish a
+ * new chain snapshot; processFrame() pins the current snapshot once per
+ * frame without taking any lock, so changes from the plugin manager window
+ * never stall frame processing. A snapshot that is replaced mid-frame stays
+ * alive until that frame is done with it.
  */
 class VideoPluginManager : public QObject
 {
     Q_OBJECT
 
 public:
+    /**
+     * @brief Resolution the chain runs at
+     */
+    enum class ProcessingMode {
+        Interactive, // Proxy resolution when proxy mode is enabled
+        Export       // Always full source resolution
+    };
+
     explicit VideoPluginManager(QObject *parent = nullptr);
     ~VideoPluginManager();
 
@@ -44,6 +82,44 @@ public:
      */
     void removeAllPlugins();
 
+    /**
+     * @brief Registers the plugin libraries found in a directory
+     * 
+     * Only the metadata embedded in each library is read; nothing is
+     * loaded. A discovered plugin is loaded, created and initialized the
+     * first time it is enabled through setPluginEnabled().
+     * 
+     * @param directory Directory to scan (not recursive)
+     * @return Number of new plugins discovered
+     */
+    int discoverPlugins(const QString& directory);
+
+    /**
+     * @brief Runs a discovered plugin in a separate host process
+     * 
+     * Takes effect when the plugin is loaded, i.e. the first time it is
+     * enabled. Libraries can also request isolation with "isolated": true
+     * in their metadata.
+     * 
+     * @param pluginName Name of a discovered plugin
+     * @param isolated true to load it out of process
+     * @return true if the plugin is known and not loaded yet
+     */
+    bool setPluginIsolated(const QString& pluginName, bool isolated);
+
+    /**
+     * @brief Names of all known plugins, loaded or not
+     * @return Plugin names
+     */
+    QStringList getAvailablePlugins() const;
+
+    /**
+     * @brief Metadata of a discovered plugin
+     * @param pluginName Plugin name
+     * @return name, version, description, priority, file and loaded; empty if unknown
+     */
+    QVariantMap getPluginMetadata(const QString& pluginName) const;
+
     /**
      * @brief Gets a plugin by name
      * @param pluginName Plugin name
@@ -60,14 +136,101 @@ public:
     /**
      * @brief Processes a frame through all enabled plugins
      * 
-     * Plugins are executed in priority order (lower first)
+     * Plugins are executed in priority order (lower first), except that a
+     * plugin producing a frame context key always runs before the plugins
+     * consuming it. Context entries are released after their last
+     * consumer, and all of them when the frame is done.
+     * In interactive proxy mode the frame may come back smaller than it
+     * went in, at the resolution the last plugin worked on.
      * 
      * @param frame Frame to be processed (modified in-place)
      * @param timestamp Frame timestamp in milliseconds
      * @param frameIndex Frame index
+     * @param mode Interactive (proxy allowed) or export (full resolution)
      * @return true if all plugins processed successfully
      */
-    bool processFrame(cv::Mat& frame, qint64 timestamp, qint64 frameIndex);
+    bool processFrame(cv::Mat& frame, qint64 timestamp, qint64 frameIndex,
+                      ProcessingMode mode = ProcessingMode::Interactive);
+
+    /**
+     * @brief Enables display-resolution proxy processing
+     * 
+     * Each plugin receives the smallest pyramid level meeting its declared
+     * minimum resolution; visual plugins get one matched to the display.
+     * 
+     * @param enabled true to process interactive frames at proxy resolution
+     */
+    void setProxyEnabled(bool enabled);
+    bool isProxyEnabled() const;
+
+    /**
+     * @brief Keeps a reference to the unprocessed frame for A/B display
+     * 
+     * The original shares its buffer with the frame passed to
+     * processFrame(); the first writing plugin then works on a copy, so
+     * there is at most one clone per frame and none with read-only chains.
+     * 
+     * @param keep true to keep the original of each processed frame
+     */
+    void setKeepOriginal(bool keep);
+    bool isKeepOriginal() const;
+
+    /**
+     * @brief Counts processed frames, clones and checkpoints under a per-view scope
+     * 
+     * Must not be called while frames are being processed.
+     * 
+     * @param scope Prefix from MetricNames::scoped(), empty for the unscoped names
+     */
+    void setMetricsScope(const QString& scope);
+
+    /**
+     * @brief Unprocessed version of the last processed frame
+     * @return Shared view, empty unless setKeepOriginal(true)
+     */
+    cv::Mat originalFrame() const;
+
+    /**
+     * @brief Number of frame copies made to protect shared buffers
+     */
+    qint64 getCloneCount() const;
+
+    /**
+     * @brief Number of frames run through the chain
+     */
+    qint64 getProcessedFrameCount() const;
+
+    /**
+     * @brief Sets the size, in device pixels, frames are displayed at
+     * @param size Display size
+     */
+    void setDisplaySize(const cv::Size& size);
+
+    /**
+     * @brief Moves the overlay primitives of the last processed frame out
+     * 
+     * Swaps buffers with the caller, so no commands are copied and both
+     * lists keep their capacity between frames.
+     * 
+     * @param target Receives the overlay commands of the last frame
+     */
+    void takeOverlayCommands(OverlayCommandList& target);
+
+    /**
+     * @brief Per-plugin processFrame latency since the last reset
+     * @return One entry per plugin that is loaded, in priority order
+     */
+    QList<PluginLatency> getPluginLatencies() const;
+
+    /**
+     * @brief Latency of the whole chain per frame since the last reset
+     */
+    LatencyStats getChainLatency() const;
+
+    /**
+     * @brief Drops all recorded latency samples
+     */
+    void resetLatencyStats();
 
     /**
      * @brief Initializes all plugins with video information
@@ -97,12 +260,52 @@ public:
 
     /**
      * @brief Notifies plugins about a seek
-     * @param position New position in milliseconds
+     * 
+     * Plugins supporting state snapshots get the latest checkpoint taken
+     * before the new position, within the maximum distance, restored ahead
+     * of the next frame. The caller then feeds the frames after the checkpoint up
+     * to the target through processFrame(), so the state catches up. With
+     * no checkpoint in reach the plugins start over at the target.
+     * 
+     * @param position PTS of the next frame to process, in milliseconds
+     * @return Frame index of the restored checkpoint, -1 if none
+     */
+    qint64 notifySeek(qint64 position);
+
+    /**
+     * @brief Sets how often plugin state is checkpointed
+     * @param frames Interval in frames, 0 disables checkpoints
      */
-    void notifySeek(qint64 position);
+    void setCheckpointInterval(int frames);
+    int checkpointInterval() const;
+
+    /**
+     * @brief Bounds the checkpoint store
+     * @param checkpoints Maximum number of checkpoints kept
+     */
+    void setCheckpointCapacity(int checkpoints);
+
+    /**
+     * @brief Oldest checkpoint, relative to a seek target, still restored
+     *
+     * Bounds how many frames a seek replays. The default (-1) is one
+     * checkpoint interval at the video's rate.
+     *
+     * @param milliseconds Maximum distance before the seek position, -1 for the default
+     */
+    void setCheckpointMaxDistance(qint64 milliseconds);
+
+    /**
+     * @brief Number of checkpoints currently stored
+     */
+    int getCheckpointCount() const;
 
     /**
      * @brief Enables or disables a plugin by name
+     * 
+     * Enabling a discovered plugin that is not loaded yet loads its library
+     * and initializes it with the current video information first.
+     * 
      * @param pluginName Plugin name
      * @param enabled true to enable, false to disable
      * @return true if the plugin was found and modified
@@ -142,12 +345,80 @@ signals:
     void pluginStateChanged(const QString& pluginName, bool enabled);
 
 private:
+    /**
+     * @brief Immutable list of enabled plugins in execution order
+     */
+    struct PluginChain
+    {
+        std::vector<std::shared_ptr<IVideoPlugin>> plugins;
+        std::vector<std::shared_ptr<LatencyHistogram>> latency; // Per plugins[i]
+        std::vector<const char*> traceNames;   // Interned plugin names for Tracer
+        std::vector<QStringList> releaseAfter; // Context keys last read by plugins[i]
+        QSet<QString> consumedKeys;            // Keys read by any plugin
+        std::vector<QSet<QString>> wantedAfter; // Keys read by plugins after plugins[i]
+    };
+
+    static void orderByDependencies(std::vector<std::shared_ptr<IVideoPlugin>>& plugins);
+
+    /**
+     * @brief Plugin library known from its metadata
+     */
+    struct DiscoveredPlugin
+    {
+        QString name;
+        QVariantMap metadata;
+        std::unique_ptr<QPluginLoader> loader;
+        bool loaded = false;
+        bool isolated = false;
+    };
+
+    std::shared_ptr<IVideoPlugin> loadDiscoveredPlugin(const QString& pluginName);
+    std::shared_ptr<LatencyHistogram> latencyFor(const QString& pluginName);
+    void captureCheckpoint(const PluginChain& chain, qint64 timestamp, qint64 frameIndex);
+    void restorePendingCheckpoint(const PluginChain& chain);
+    bool isSharedElsewhere(const cv::Mat& working, const cv::Mat& frame, bool useProxy) const;
     void sortPluginsByPriority();
+    cv::Size requiredResolution(const std::shared_ptr<IVideoPlugin>& plugin,
+                                const cv::Size& sourceSize) const;
     void updateEnabledPluginsCache();
 
-    QList<std::shared_ptr<IVideoPlugin>> m_plugins;
-    QList<std::shared_ptr<IVideoPlugin>> m_enabledPlugins; // Cache for performance
-    bool m_needsSort;
+    // Declared first so plugin objects are released before their libraries
+    std::vector<DiscoveredPlugin> m_discovered;
+    QVariantMap m_videoInfo; // For plugins initialized after the video was loaded
+
+    QList<std::shared_ptr<IVideoPlugin>> m_plugins; // UI side list, kept sorted
+    RcuPointer<PluginChain> m_chain;                // Enabled plugins seen by processFrame
+    QMutex m_chainWriteMutex;                       // Serializes chain publishers
+    OverlayCommandList m_overlay; // Vector overlays of the last processed frame
+    FrameContext m_context;       // Metadata shared by the chain, reused per frame
+
+    // Timing (histograms are shared with chain snapshots)
+    QHash<QString, std::shared_ptr<LatencyHistogram>> m_latency;
+    LatencyHistogram m_chainLatency;
+
+    // Plugin state checkpoints
+    PluginCheckpointStore m_checkpoints;
+    std::atomic<int> m_checkpointInterval;
+    std::atomic<qint64> m_checkpointMaxDistance; // -1: one checkpoint interval
+    QMutex m_pendingRestoreMutex;
+    std::shared_ptr<const PluginCheckpoint> m_pendingRestore; // Applied before the next frame
+    std::atomic<bool> m_restorePending; // Lock-free check for m_pendingRestore
+
+    // Copy-on-write bookkeeping
+    bool m_keepOriginal;
+    cv::Mat m_original;
+    std::atomic<qint64> m_cloneCount;
+    std::atomic<qint64> m_processedFrames;
+
+    // Per-view totals (owned by MetricsRegistry)
+    MetricCounter* m_processedMetric;
+    MetricCounter* m_cloneMetric;
+    MetricGauge* m_checkpointMetric;
+
+    // Proxy processing
+    bool m_proxyEnabled;
+    cv::Size m_displaySize;
+    FramePyramid m_pyramid;
 };
 
 #endif // VIDEOPLUGINMANAGER_H
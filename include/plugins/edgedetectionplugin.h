@@ -2,7 +2,9 @@
 #define EDGEDETECTIONPLUGIN_H
 
 #include "ivideoplugin.h"
+#include "settingssnapshot.h"
 #include <opencv2/opencv.hpp>
+#include <atomic>
 
 /**
  * @brief Example plugin that applies edge detection (Canny)
@@ -11,6 +13,14 @@
  * - Image processing with OpenCV
  * - Adjustable settings
  * - Visualization mode (original, edges, or blend)
+ * 
+ * The frame is processed in row tiles with cv::parallel_for_; blur, Canny,
+ * colorize and blend run back to back on each tile so it stays in cache.
+ * 
+ * Publishes its gray plane as FrameKeys::Gray when a later plugin reads it.
+ * 
+ * Settings are published from the UI thread as immutable snapshots and
+ * picked up once per frame, so live tuning never tears a parameter set.
  */
 class EdgeDetectionPlugin : public IVideoPlugin
 {
@@ -26,8 +36,12 @@ public:
 
     // IVideoPlugin interface
     bool processFrame(cv::Mat& frame, qint64 timestamp, qint64 frameIndex) override;
+    bool processFrame(cv::Mat& frame, FrameContext& context) override;
+    void setHost(IPluginHost* host) override;
+    QStringList producedKeys() const override;
     void initialize(const QVariantMap& videoInfo) override;
     void finalize() override;
+    void onSeek(qint64 position) override;
     
     QString getName() const override;
     QString getVersion() const override;
@@ -40,6 +54,7 @@ public:
     QVariantMap getSettings() const override;
     
     int getPriority() const override;
+    bool isVisualPlugin() const override;
 
     // Specific settings
     void setThresholds(int low, int high);
@@ -47,23 +62,67 @@ public:
     void setBlendAlpha(double alpha);
     void setEdgeColor(const cv::Scalar& color);
 
+    /**
+     * @brief Enables motion-masked incremental detection
+     * 
+     * For static cameras: only tiles where a downscaled frame difference
+     * shows motion (plus their neighbours) are re-run through blur and
+     * Canny, the rest of the previous edge map is reused.
+     */
+    void setIncrementalMode(bool incremental);
+
+    /**
+     * @brief Fraction of tiles recomputed for the last frame (0.0 - 1.0)
+     */
+    double recomputedTileFraction() const;
+
 private:
-    void detectEdges(const cv::Mat& input, cv::Mat& output);
-    void applyColorToEdges(cv::Mat& edges);
+    friend class PipelineBenchmark; // Times applyColorToEdges in isolation
 
-    bool m_enabled;
-    
-    // Detection parameters
-    int m_lowThreshold;
-    int m_highThreshold;
-    
-    // Visualization mode
-    ViewMode m_viewMode;
-    double m_blendAlpha;  // For Blend mode (0.0 - 1.0)
-    
-    // Edge color (in color mode)
-    cv::Scalar m_edgeColor;
-    bool m_useColorEdges;
+    struct Settings
+    {
+        // Detection parameters
+        int lowThreshold = 50;
+        int highThreshold = 150;
+
+        // Visualization mode
+        ViewMode viewMode = ViewMode::Blend;
+        double blendAlpha = 0.5;  // For Blend mode (0.0 - 1.0)
+
+        // Edge color (in color mode)
+        cv::Scalar edgeColor = cv::Scalar(0, 255, 0);  // Green
+        bool useColorEdges = true;
+
+        bool incremental = false;
+    };
+
+    void detectEdgesIncremental(cv::Mat& frame, const Settings& settings);
+    void updateScratchCharge();
+
+    /**
+     * @brief Colorizes edges and blends them into the frame in one pass
+     * @param frame RGB frame rows (modified in place)
+     * @param edges Edge mask of the same rows
+     * @param settings Settings of the current frame
+     */
+    static void applyColorToEdges(cv::Mat& frame, const cv::Mat& edges, const Settings& settings);
+
+    std::atomic<bool> m_enabled;
+    SettingsSnapshot<Settings> m_settings;
+
+    // Full-frame gray plane shared by the tiles
+    cv::Mat m_gray;
+
+    // Incremental mode state (processing thread)
+    std::atomic<bool> m_edgesValid;
+    cv::Mat m_edges;          // Edge map reused for unchanged tiles
+    cv::Mat m_referenceGray;  // Downscaled gray each tile was computed from
+    int m_lastLowThreshold;
+    int m_lastHighThreshold;
+    std::atomic<double> m_recomputedFraction;
+
+    // Full-resolution buffers above, charged to PluginScratch
+    PluginMemoryCharge m_scratchCharge;
 };
 
 #endif // EDGEDETECTIONPLUGIN_H
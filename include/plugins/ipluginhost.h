@@ -0,0 +1,82 @@
+#ifndef IPLUGINHOST_H
+#define IPLUGINHOST_H
+
+#include "core/memoryaccountant.h"
+#include <QtGlobal>
+
+/**
+ * @brief Services the application offers to plugins
+ *
+ * Plugin libraries are loaded as modules and do not link the application's
+ * core, so they reach it through this interface only. The manager hands it
+ * to each plugin with IVideoPlugin::setHost(); it outlives the plugin.
+ */
+class IPluginHost
+{
+public:
+    virtual ~IPluginHost() = default;
+
+    /**
+     * @brief Adjusts the bytes a plugin holds in a subsystem (any thread)
+     * @param delta Bytes allocated (positive) or released (negative)
+     */
+    virtual void chargeMemory(MemorySubsystem subsystem, qint64 delta) = 0;
+};
+
+/**
+ * @brief Bytes held by one plugin buffer set, charged through the host
+ *
+ * The plugin-side counterpart of MemoryCharge: set() reports the new size
+ * and only the difference reaches the host. Without a host (a plugin driven
+ * directly, as in a benchmark) nothing is reported. Not thread safe, like
+ * the buffers it describes.
+ */
+class PluginMemoryCharge
+{
+public:
+    explicit PluginMemoryCharge(MemorySubsystem subsystem)
+        : m_subsystem(subsystem)
+        , m_host(nullptr)
+        , m_bytes(0)
+    {
+    }
+
+    ~PluginMemoryCharge()
+    {
+        set(0);
+    }
+
+    PluginMemoryCharge(const PluginMemoryCharge&) = delete;
+    PluginMemoryCharge& operator=(const PluginMemoryCharge&) = delete;
+
+    /**
+     * @brief Moves the current charge to another host (or none)
+     */
+    void setHost(IPluginHost* host)
+    {
+        const qint64 bytes = m_bytes;
+        set(0);
+        m_host = host;
+        set(bytes);
+    }
+
+    void set(qint64 bytes)
+    {
+        if (m_host && bytes != m_bytes) {
+            m_host->chargeMemory(m_subsystem, bytes - m_bytes);
+        }
+        m_bytes = bytes;
+    }
+
+    qint64 bytes() const
+    {
+        return m_bytes;
+    }
+
+private:
+    MemorySubsystem m_subsystem;
+    IPluginHost* m_host;
+    qint64 m_bytes;
+};
+
+#endif // IPLUGINHOST_H
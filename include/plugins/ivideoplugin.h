@@ -3,7 +3,13 @@
 
 #include <opencv2/opencv.hpp>
 #include <QString>
+#include <QStringList>
+#include <QVariant>
 #include <QVariantMap>
+#include "core/framecontext.h"
+#include "core/overlaycommandlist.h"
+#include "ipluginhost.h"
+#include "settingssnapshot.h"
 
 /**
  * @brief Abstract interface for video processing plugins
@@ -19,6 +25,14 @@
 class IVideoPlugin
 {
 public:
+    /**
+     * @brief How a plugin uses the frame it is given
+     */
+    enum class FrameAccess {
+        ReadOnly,  // Analysis only, pixels are never written
+        ReadWrite  // May draw on or replace the frame
+    };
+
     virtual ~IVideoPlugin() = default;
 
     /**
@@ -35,6 +49,75 @@ public:
      */
     virtual bool processFrame(cv::Mat& frame, qint64 timestamp, qint64 frameIndex) = 0;
 
+    /**
+     * @brief Processes a video frame with access to the frame context
+     * 
+     * This is what the manager calls. Plugins that share results with
+     * other plugins override it, publish what they list in producedKeys()
+     * and read what they list in consumedKeys(). The default forwards to
+     * the context-free overload.
+     * 
+     * @param frame Video frame (can be modified)
+     * @param context Values published earlier in the chain for this frame
+     * @return true if processing was successful, false otherwise
+     */
+    virtual bool processFrame(cv::Mat& frame, FrameContext& context)
+    {
+        return processFrame(frame, context.timestamp(), context.frameIndex());
+    }
+
+    /**
+     * @brief Declares whether the next processFrame() call writes the frame
+     * 
+     * Queried by the manager on the processing thread right before each
+     * processFrame() call. Read-only plugins get a view sharing the buffer
+     * and may keep it (e.g. in the frame context); they must not write to
+     * it. Writers get a private copy only if someone else still holds the
+     * buffer, so a chain of readers never copies a frame.
+     * 
+     * @return FrameAccess::ReadWrite (default) or FrameAccess::ReadOnly
+     */
+    virtual FrameAccess frameAccess() const { return FrameAccess::ReadWrite; }
+
+    /**
+     * @brief Frame context keys this plugin publishes
+     * 
+     * Producers run before their consumers regardless of priority.
+     */
+    virtual QStringList producedKeys() const { return QStringList(); }
+
+    /**
+     * @brief Frame context keys this plugin reads
+     * 
+     * A consumed value may still be missing for a frame (producer disabled
+     * or skipped), so consumers must handle a null result.
+     */
+    virtual QStringList consumedKeys() const { return QStringList(); }
+
+    /**
+     * @brief Emits vector overlay primitives for the current frame
+     * 
+     * Called right after processFrame. Primitives added here are rendered
+     * by the video widget on top of the frame texture instead of being
+     * rasterized into the frame, so they stay crisp at any window size.
+     * 
+     * @param overlay Command list for the current frame (frame coordinates)
+     * @param timestamp Frame timestamp in milliseconds
+     * @param frameIndex Current frame index
+     */
+    virtual void emitOverlay(OverlayCommandList& overlay, qint64 timestamp, qint64 frameIndex) {}
+
+    /**
+     * @brief Hands the plugin the application's services
+     * 
+     * Called once when the plugin is added to a manager, before
+     * initialize(). Plugins with large buffers charge them through
+     * PluginMemoryCharge::setHost().
+     * 
+     * @param host Host services, valid for the plugin's lifetime
+     */
+    virtual void setHost(IPluginHost* host) {}
+
     /**
      * @brief Initializes the plugin with video information
      * 
@@ -72,6 +155,37 @@ public:
      */
     virtual void onSeek(qint64 position) {}
 
+    /**
+     * @brief Whether the plugin keeps state worth checkpointing
+     * 
+     * Stateful plugins (trackers, temporal filters, running estimates)
+     * return true so the manager checkpoints them periodically and
+     * restores the nearest checkpoint after a seek instead of letting them
+     * reconverge from scratch.
+     */
+    virtual bool supportsStateSnapshot() const { return false; }
+
+    /**
+     * @brief Captures the plugin state after the frame just processed
+     * 
+     * Called on the processing thread right after processFrame(), every
+     * few frames. Should be cheap and self-contained (value types only).
+     * 
+     * @return State to hand back to restoreState()
+     */
+    virtual QVariant snapshotState() const { return QVariant(); }
+
+    /**
+     * @brief Restores a state captured by snapshotState()
+     * 
+     * Called on the processing thread before the first frame after a seek,
+     * after onSeek(). The state belongs to a frame at or shortly before
+     * the seek target.
+     * 
+     * @param state Value returned by snapshotState()
+     */
+    virtual void restoreState(const QVariant& state) {}
+
     /**
      * @brief Returns the plugin name
      */
@@ -100,12 +214,22 @@ public:
 
     /**
      * @brief Sets plugin settings
+     * 
+     * Called from the UI thread, possibly while frames are processed on
+     * another one. Implementations should build a complete settings object
+     * and hand it over with SettingsSnapshot::publish(), then read it in
+     * processFrame() through SettingsSnapshot::acquire() once per frame.
+     * 
      * @param settings Settings map
      */
     virtual void setSettings(const QVariantMap& settings) {}
 
     /**
      * @brief Gets plugin settings
+     * 
+     * A "status" entry (QString) is read-only: a short live figure about
+     * the last frame that the host shows next to the plugin's latency.
+     * 
      * @return Settings map
      */
     virtual QVariantMap getSettings() const { return QVariantMap(); }
@@ -119,6 +243,26 @@ public:
      * @return Priority value (default: 100)
      */
     virtual int getPriority() const { return 100; }
+
+    /**
+     * @brief Smallest frame size the plugin can work with in proxy mode
+     * 
+     * In proxy mode the manager hands each plugin the smallest level of a
+     * resolution pyramid that still meets this size.
+     * 
+     * @return Minimum size, or an empty size for full resolution (default)
+     */
+    virtual cv::Size getMinimumResolution() const { return cv::Size(); }
+
+    /**
+     * @brief Whether the plugin output is only meant to be looked at
+     * 
+     * In proxy mode visual plugins receive a frame matched to the size of
+     * the video widget instead of the source resolution.
+     * 
+     * @return true for visual plugins (default: false)
+     */
+    virtual bool isVisualPlugin() const { return false; }
 };
 
 #endif // IVIDEOPLUGIN_H
@@ -0,0 +1,51 @@
+#ifndef IVIDEOPLUGINFACTORY_H
+#define IVIDEOPLUGINFACTORY_H
+
+#include "ivideoplugin.h"
+#include <QtPlugin>
+#include <memory>
+
+/**
+ * @brief Entry point of a video plugin shipped as a shared library
+ * 
+ * A plugin library exports one QObject implementing this interface:
+ * 
+ * @code
+ * class MyPluginFactory : public QObject, public IVideoPluginFactory
+ * {
+ *     Q_OBJECT
+ *     Q_PLUGIN_METADATA(IID IVideoPluginFactory_iid FILE "myplugin.json")
+ *     Q_INTERFACES(IVideoPluginFactory)
+ * public:
+ *     std::shared_ptr<IVideoPlugin> createPlugin() override;
+ * };
+ * @endcode
+ * 
+ * The JSON file is embedded in the library and can be read without loading
+ * it. VideoPluginManager uses it to list the plugin at startup:
+ * - "name": must match IVideoPlugin::getName() of the created plugin
+ * - "version", "description": shown before the plugin is loaded
+ * - "priority": execution priority, informational until loaded
+ * - "isolated": load the plugin in a separate host process by default
+ * - "readOnly", "visual": frame access and visual flag of an isolated plugin
+ */
+class IVideoPluginFactory
+{
+public:
+    virtual ~IVideoPluginFactory() = default;
+
+    /**
+     * @brief Creates the plugin instance
+     * 
+     * Called once, the first time the plugin is enabled. Heavy resources
+     * (models, sessions) should still be acquired in initialize().
+     * 
+     * @return New plugin, or nullptr on failure
+     */
+    virtual std::shared_ptr<IVideoPlugin> createPlugin() = 0;
+};
+
+#define IVideoPluginFactory_iid "com.blazestudio.IVideoPluginFactory/1.0"
+Q_DECLARE_INTERFACE(IVideoPluginFactory, IVideoPluginFactory_iid)
+
+#endif // IVIDEOPLUGINFACTORY_H
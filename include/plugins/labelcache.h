@@ -0,0 +1,104 @@
+#ifndef LABELCACHE_H
+#define LABELCACHE_H
+
+#include "core/memoryaccountant.h"
+#include <opencv2/core.hpp>
+#include <QString>
+#include <QtGlobal>
+#include <list>
+#include <unordered_map>
+
+/**
+ * @brief Pre-rendered text label with alpha
+ *
+ * Stored in a form that composites with a single multiply-add per channel:
+ * dst = dst * scale / 255 + addend. The background box and the antialiased
+ * text coverage are both folded into the two planes.
+ */
+struct LabelBitmap
+{
+    cv::Mat scale;   // CV_8UC1, how much of the destination survives (255 = all)
+    cv::Mat addend;  // CV_8UC3, premultiplied text color
+    cv::Point offset; // Top-left of the bitmap relative to the text origin
+};
+
+/**
+ * @brief Cache of rendered labels keyed by text, font, scale and color
+ *
+ * Static labels (playback state, resolution) are rendered once and then
+ * only blended into each frame. Labels that change every frame (timestamps,
+ * frame numbers) would only churn it and should be rendered with render()
+ * instead. Entries are evicted in LRU order once the cache is full, or once
+ * it is down to a quarter of its capacity while the memory budget is under
+ * pressure.
+ */
+class LabelCache
+{
+public:
+    explicit LabelCache(size_t capacity = 64);
+
+    /**
+     * @brief Returns the bitmap for a label, rendering it on a miss
+     * @param color Text color in frame channel order
+     * @param backgroundOpacity Opacity of the black box behind the text (0.0 - 1.0)
+     */
+    const LabelBitmap& get(const QString& text, int fontFace, double fontScale,
+                           int thickness, const cv::Vec3b& color, double backgroundOpacity);
+
+    /**
+     * @brief Renders a label without caching it, for text that changes every frame
+     */
+    static LabelBitmap render(const QString& text, int fontFace, double fontScale,
+                              int thickness, const cv::Vec3b& color, double backgroundOpacity);
+
+    /**
+     * @brief Blends a label into an 8-bit 3-channel frame in place
+     * @param origin Text origin (baseline left), as for cv::putText
+     */
+    static void composite(cv::Mat& frame, const LabelBitmap& label, const cv::Point& origin);
+
+    void clear();
+    size_t size() const;
+    quint64 hits() const;
+    quint64 misses() const;
+
+private:
+    struct Key
+    {
+        QString text;
+        int fontFace;
+        int scaleMilli;
+        int thickness;
+        cv::Vec3b color;
+        int opacity;
+
+        bool operator==(const Key& other) const;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry
+    {
+        LabelBitmap bitmap;
+        std::list<Key>::iterator recency; // Position in m_recency
+    };
+
+    static Key makeKey(const QString& text, int fontFace, double fontScale,
+                       int thickness, const cv::Vec3b& color, double backgroundOpacity);
+    static LabelBitmap renderKey(const Key& key);
+    static qint64 bitmapBytes(const LabelBitmap& bitmap);
+    void evictLeastRecentlyUsed();
+
+    std::unordered_map<Key, Entry, KeyHash> m_labels;
+    std::list<Key> m_recency; // Most recently used first
+    size_t m_capacity;
+    quint64 m_hits;
+    quint64 m_misses;
+    qint64 m_bytes;
+    MemoryCharge m_charge;
+};
+
+#endif // LABELCACHE_H
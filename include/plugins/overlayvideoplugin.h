@@ -2,8 +2,13 @@
 #define OVERLAYVIDEOPLUGIN_H
 
 #include "ivideoplugin.h"
+#include "labelcache.h"
+#include "settingssnapshot.h"
+#include "core/metricsregistry.h"
 #include <QColor>
 #include <QFont>
+#include <QStringList>
+#include <atomic>
 
 /**
  * @brief Example plugin that draws overlays on video
@@ -18,7 +23,10 @@ public:
     virtual ~OverlayVideoPlugin() = default;
 
     // IVideoPlugin interface
+    using IVideoPlugin::processFrame;
     bool processFrame(cv::Mat& frame, qint64 timestamp, qint64 frameIndex) override;
+    bool processFrame(cv::Mat& frame, FrameContext& context) override;
+    void emitOverlay(OverlayCommandList& overlay, qint64 timestamp, qint64 frameIndex) override;
     void initialize(const QVariantMap& videoInfo) override;
     void finalize() override;
     
@@ -27,6 +35,10 @@ public:
     void onPlaybackStopped() override;
     void onSeek(qint64 position) override;
 
+    bool supportsStateSnapshot() const override;
+    QVariant snapshotState() const override;
+    void restoreState(const QVariant& state) override;
+
     QString getName() const override;
     QString getVersion() const override;
     QString getDescription() const override;
@@ -38,21 +50,49 @@ public:
     QVariantMap getSettings() const override;
     
     int getPriority() const override;
+    bool isVisualPlugin() const override;
+    FrameAccess frameAccess() const override;
 
     // Overlay specific settings
     void setShowFPS(bool show);
     void setShowTimestamp(bool show);
     void setShowFrameCount(bool show);
     void setShowResolution(bool show);
+    void setShowHealth(bool show);
     void setTextColor(const QColor& color);
     void setBackgroundOpacity(double opacity);
+    void setVectorOverlay(bool vector);
 
 private:
-    void drawOverlay(cv::Mat& frame, qint64 timestamp, qint64 frameIndex);
-    void drawText(cv::Mat& frame, const QString& text, int x, int y);
-    QString formatTimestamp(qint64 timestampMs);
+    friend class PipelineBenchmark; // Times drawText in isolation
+
+    struct Settings
+    {
+        bool showFPS = true;
+        bool showTimestamp = false;   // Disabled by default for performance
+        bool showFrameCount = false;  // Disabled by default for performance
+        bool showResolution = false;
+        bool showHealth = false;      // Pipeline health from MetricsRegistry
+        QColor textColor = Qt::white;
+        double backgroundOpacity = 0.5;
+        bool vectorOverlay = true;    // Emit GL overlay commands instead of drawing into the frame
+    };
+
+    struct InfoLine
+    {
+        QString text;
+        bool perFrame; // Changes every frame, not worth caching its label
+    };
 
-    bool m_enabled;
+    bool process(cv::Mat& frame, qint64 timestamp, qint64 frameIndex, bool writable);
+    QList<InfoLine> buildInfoLines(const Settings& settings, qint64 timestamp, qint64 frameIndex) const;
+    void drawOverlay(cv::Mat& frame, const Settings& settings, qint64 timestamp, qint64 frameIndex);
+    void drawText(cv::Mat& frame, const Settings& settings, const QString& text, int x, int y,
+                  bool perFrame = false);
+    QString formatTimestamp(qint64 timestampMs) const;
+    void refreshHealth();
+
+    std::atomic<bool> m_enabled;
     
     // Video information
     int m_videoWidth;
@@ -60,21 +100,31 @@ private:
     double m_videoFps;
     qint64 m_videoDuration;
     
-    // Display settings
-    bool m_showFPS;
-    bool m_showTimestamp;
-    bool m_showFrameCount;
-    bool m_showResolution;
-    QColor m_textColor;
-    double m_backgroundOpacity;
+    // Display settings (published by the UI thread, read once per frame)
+    SettingsSnapshot<Settings> m_settings;
+
+    // Raster mode needs write access; set before the settings are published
+    std::atomic<bool> m_rasterOverlay;
     
     // Playback state
-    bool m_isPlaying;
+    std::atomic<bool> m_isPlaying;
     
-    // Real FPS calculation
-    qint64 m_lastFrameTime;
-    double m_currentFPS;
+    // Rates derived from the metrics registry (processing thread)
+    QString m_metricsScope; // The view this plugin draws on
+    MetricsSnapshot m_lastSnapshot;
+    double m_currentFPS; // Presented frames per second
+    double m_decodeFPS;
+    double m_pluginFPS;
+    qint64 m_droppedFrames;
+    double m_presentLagMs; // Media clock minus PTS of the shown frame
+    double m_avDriftMs;    // Audio position minus media clock
+    qint64 m_residentBytes;
+    qint64 m_accountedBytes; // MemoryAccountant total
+    qint64 m_memoryBudget;
     int m_frameCounter;
+
+    // Pre-rendered labels for the raster path
+    LabelCache m_labelCache;
 };
 
 #endif // OVERLAYVIDEOPLUGIN_H
@@ -0,0 +1,88 @@
+#ifndef REMOTEVIDEOPLUGIN_H
+#define REMOTEVIDEOPLUGIN_H
+
+#include "ivideoplugin.h"
+#include "core/sharedframering.h"
+#include "core/memoryaccountant.h"
+#include <QJsonObject>
+#include <QMutex>
+#include <QVariantMap>
+#include <atomic>
+#include <memory>
+
+class QProcess;
+
+/**
+ * @brief Runs a plugin library in a separate blazestudio_pluginhost process
+ * 
+ * A crashing, hanging or thread-hungry plugin only takes its host down:
+ * the proxy reports failure for the frame, leaves it untouched and stays
+ * failed until the next initialize() restarts the host.
+ * 
+ * Frames travel through a SharedFrameRing. Each frame is copied once into
+ * a shared slot (in parallel bands) and processed there by the host; only
+ * plugins declared as writers have the result copied back. Control calls
+ * (initialize, seek, settings...) are small JSON commands in the same
+ * control block.
+ * 
+ * Name, version, priority and access mode come from the library metadata
+ * ("readOnly" and "visual" booleans), so the proxy never loads the library
+ * itself. Remote plugins do not take part in the frame context.
+ */
+class RemoteVideoPlugin : public IVideoPlugin
+{
+public:
+    RemoteVideoPlugin(const QString& libraryPath, const QVariantMap& metadata);
+    ~RemoteVideoPlugin() override;
+
+    // IVideoPlugin interface
+    using IVideoPlugin::processFrame;
+    bool processFrame(cv::Mat& frame, qint64 timestamp, qint64 frameIndex) override;
+    void initialize(const QVariantMap& videoInfo) override;
+    void finalize() override;
+    void onPlaybackStarted() override;
+    void onPlaybackPaused() override;
+    void onPlaybackStopped() override;
+    void onSeek(qint64 position) override;
+
+    QString getName() const override;
+    QString getVersion() const override;
+    QString getDescription() const override;
+
+    bool isEnabled() const override;
+    void setEnabled(bool enabled) override;
+
+    void setSettings(const QVariantMap& settings) override;
+    QVariantMap getSettings() const override;
+
+    int getPriority() const override;
+    bool isVisualPlugin() const override;
+    FrameAccess frameAccess() const override;
+
+    /**
+     * @brief Whether the host process is running and answering
+     */
+    bool isHostAlive() const;
+
+private:
+    bool startHost(size_t slotBytes);
+    void stopHost();
+    bool sendCommand(const QJsonObject& command, int timeoutMs);
+    void markFailed(const char* reason);
+
+    QString m_libraryPath;
+    QVariantMap m_metadata;
+
+    std::atomic<bool> m_enabled;
+    std::atomic<bool> m_hostFailed;
+    QVariantMap m_settings;
+
+    // Host process and transport; one transaction at a time
+    mutable QMutex m_channelMutex;
+    std::unique_ptr<QProcess> m_process;
+    SharedFrameRing m_ring;
+    uint32_t m_nextSlot;
+    MemoryCharge m_ringCharge; // Frame slots while the ring is open
+};
+
+#endif // REMOTEVIDEOPLUGIN_H
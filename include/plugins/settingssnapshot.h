@@ -0,0 +1,103 @@
+#ifndef SETTINGSSNAPSHOT_H
+#define SETTINGSSNAPSHOT_H
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief Lock-free handoff of immutable plugin settings between threads
+ *
+ * The UI thread publishes a complete settings object; the processing thread
+ * picks up the latest one once per frame. A frame therefore always sees one
+ * consistent parameter set, and neither side ever blocks:
+ * - publish() allocates a new immutable copy and swaps it into a single
+ *   atomic pointer. A copy the processing side never picked up is freed by
+ *   the publisher, since the exchange makes it the sole owner.
+ * - acquire() exchanges the pointer with null and, if it got a new object,
+ *   takes ownership and drops the previous one.
+ *
+ * Single publisher (UI thread) and single consumer (processing thread).
+ */
+template<typename T>
+class SettingsSnapshot
+{
+public:
+    SettingsSnapshot()
+        : SettingsSnapshot(T())
+    {
+    }
+
+    explicit SettingsSnapshot(const T& initial)
+        : m_published(initial)
+        , m_current(new T(initial))
+        , m_pending(nullptr)
+    {
+    }
+
+    ~SettingsSnapshot()
+    {
+        delete m_pending.load(std::memory_order_acquire);
+    }
+
+    SettingsSnapshot(const SettingsSnapshot&) = delete;
+    SettingsSnapshot& operator=(const SettingsSnapshot&) = delete;
+
+    /**
+     * @brief Publishes a new settings set (UI thread)
+     */
+    void publish(const T& settings)
+    {
+        m_published = settings;
+        T* stale = m_pending.exchange(new T(settings), std::memory_order_acq_rel);
+        delete stale;
+    }
+
+    /**
+     * @brief Modifies a copy of the last published settings and publishes it (UI thread)
+     * @param mutate Callable taking T&
+     */
+    template<typename F>
+    void update(F&& mutate)
+    {
+        T next = m_published;
+        std::forward<F>(mutate)(next);
+        publish(next);
+    }
+
+    /**
+     * @brief Last published settings (UI thread)
+     */
+    const T& published() const
+    {
+        return m_published;
+    }
+
+    /**
+     * @brief Picks up the latest settings (processing thread, once per frame)
+     * @return Settings valid until the next acquire()
+     */
+    const T& acquire()
+    {
+        T* latest = m_pending.exchange(nullptr, std::memory_order_acq_rel);
+        if (latest) {
+            m_current.reset(latest);
+        }
+        return *m_current;
+    }
+
+    /**
+     * @brief Settings returned by the last acquire() (processing thread)
+     */
+    const T& current() const
+    {
+        return *m_current;
+    }
+
+private:
+    T m_published;                 // UI side view
+    std::unique_ptr<T> m_current;  // Owned by the processing side
+    std::atomic<T*> m_pending;     // Published but not yet picked up
+};
+
+#endif // SETTINGSSNAPSHOT_H
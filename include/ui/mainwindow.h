@@ -10,6 +10,8 @@ class MainWindow;
 QT_END_NAMESPACE
 
 class VideoGLWidget;
+class PluginManagerWindow;
+class MultiViewWidget;
 
 class MainWindow : public QMainWindow
 {
@@ -22,6 +24,15 @@ public:
 private slots:
     void on_actionOpen_triggered();
 
+    void on_actionOpenMultiView_triggered();
+
+    void on_actionPluginManager_triggered();
+
+    void on_actionRecordTrace_toggled(bool checked);
+    void on_actionShowHealth_toggled(bool checked);
+
+    void on_actionCaptureRawFrames_triggered();
+
     void on_play_btn_clicked();
 
     void on_pause_btn_clicked();
@@ -30,14 +41,20 @@ private slots:
 
     void on_add_1_clicked();
 
+    void on_speed_combo_currentIndexChanged(int index);
+
+    void on_interpolate_chk_toggled(bool checked);
+
     void on_minus_01_clicked();
 
     void on_minus_1_clicked();
 
 private:
-    void setupPlugins();
+    void setupPlugins(VideoGLWidget* widget);
 
     Ui::MainWindow *ui;
     VideoGLWidget *videoWidget;
+    PluginManagerWindow *pluginManagerWindow;
+    MultiViewWidget *multiViewWidget;
 };
 #endif // MAINWINDOW_H
@@ -2,21 +2,50 @@
 #define PLUGINMANAGERWINDOW_H
 
 #include <QDialog>
+#include <QPointer>
 
 namespace Ui {
 class PluginManagerWindow;
 }
 
+class QListWidgetItem;
+class QTimer;
+class VideoGLWidget;
+struct LatencyStats;
+
+/**
+ * @brief Plugin toggles and live latency view
+ * 
+ * Lists every known plugin (including discovered ones not loaded yet) with
+ * an enable checkbox, and shows p50/p95/p99/max latency of the frame path
+ * stages and of each plugin, refreshed while the dialog is visible. Rows
+ * whose p95 exceeds the frame budget of the current video are highlighted.
+ * Below the table, the view's presentation jitter statistics.
+ */
 class PluginManagerWindow : public QDialog
 {
     Q_OBJECT
 
 public:
-    explicit PluginManagerWindow(QWidget *parent = nullptr);
+    explicit PluginManagerWindow(VideoGLWidget *videoWidget, QWidget *parent = nullptr);
     ~PluginManagerWindow();
 
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    void refreshPlugins();
+    void refreshLatency();
+    void onPluginItemChanged(QListWidgetItem *item);
+    void on_resetButton_clicked();
+
 private:
+    void setLatencyRow(int row, const QString& name, const LatencyStats& stats, double budgetMs);
+
     Ui::PluginManagerWindow *ui;
+    QPointer<VideoGLWidget> m_videoWidget; // Grid views go away on the next load
+    QTimer *m_refreshTimer;
 };
 
 #endif // PLUGINMANAGERWINDOW_H
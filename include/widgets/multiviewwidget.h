@@ -0,0 +1,93 @@
+#ifndef MULTIVIEWWIDGET_H
+#define MULTIVIEWWIDGET_H
+
+#include <QStringList>
+#include <QWidget>
+#include <vector>
+#include "core/decodepool.h"
+#include "core/mediaclock.h"
+#include "core/presentationscheduler.h"
+
+class QGridLayout;
+class QSpinBox;
+class VideoGLWidget;
+
+/**
+ * @brief Synchronized playback of several angles of the same session
+ *
+ * Every view is a VideoGLWidget with its own VideoPluginManager, following
+ * one MediaClock owned by the grid. Each time the first view is due to present, all
+ * views decode the frame due at the same media time through a shared
+ * DecodePool, then run their plugins and upload on the UI thread, so they
+ * never drift apart by more than the frame they are on.
+ *
+ * Each view shows its video at session time + its offset, which lines up
+ * recordings that were not started together. Audio comes from the first view.
+ */
+class MultiViewWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MaxViews = 4;
+
+    explicit MultiViewWidget(QWidget *parent = nullptr);
+    ~MultiViewWidget();
+
+    /**
+     * @brief Replaces the views with one per file (up to MaxViews)
+     * @return false if a file could not be opened; no views are left then
+     */
+    bool loadVideos(const QStringList& videoPaths);
+
+    void play();
+    void pause();
+    void seek(qint64 positionMs);
+    bool isPlaying() const;
+
+    /**
+     * @brief Session time in milliseconds
+     */
+    qint64 position() const;
+
+    /**
+     * @brief Shifts a view: it shows its video at session time + offset
+     */
+    void setTimeOffset(int viewIndex, qint64 offsetMs);
+    qint64 timeOffset(int viewIndex) const;
+
+    int viewCount() const;
+    VideoGLWidget* view(int viewIndex) const;
+
+signals:
+    /**
+     * @brief A view was created; emitted before its video is loaded, to set up its plugins
+     */
+    void viewCreated(VideoGLWidget* view);
+
+    /**
+     * @brief The plugin manager of a view was asked for
+     */
+    void pluginManagerRequested(VideoGLWidget* view);
+
+protected:
+    void closeEvent(QCloseEvent* event) override;
+
+private slots:
+    void onLeaderPresentationDue();
+
+private:
+    void clearViews();
+
+    QGridLayout* m_grid;
+    std::vector<QWidget*> m_cells;
+    std::vector<VideoGLWidget*> m_views;
+    std::vector<QSpinBox*> m_offsetSpins;
+
+    MediaClock m_clock; // Session time, shared by every view
+    PresentationScheduler m_scheduler;
+    DecodePool m_decodePool;
+    bool m_isPlaying;
+};
+
+#endif // MULTIVIEWWIDGET_H
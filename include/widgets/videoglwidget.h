@@ -2,11 +2,25 @@
 #define VIDEOGLWIDGET_H
 
 #include <QOpenGLWidget>
-#include <QTimer>
 #include <QMediaPlayer>
 #include <QAudioOutput>
+#include <QElapsedTimer>
+#include <QList>
+#include <QPair>
 #include <opencv2/opencv.hpp>
+#include <vector>
 #include "core/videopluginmanager.h"
+#include "core/overlaycommandlist.h"
+#include "core/presentationscheduler.h"
+#include "core/mediaclock.h"
+#include "core/timestampindex.h"
+#include "core/latencyhistogram.h"
+#include "core/metricsregistry.h"
+#include "core/memoryaccountant.h"
+#include <memory>
+
+class QTimer;
+class RawFrameWriter;
 
 class VideoGLWidget : public QOpenGLWidget
 {
@@ -22,6 +36,14 @@ public:
     // Method to clear screen
     void clearFrame();
 
+    // Vector overlays (rendered by GL on top of the frame)
+    void setOverlayVisible(bool visible);
+    bool isOverlayVisible() const;
+
+    // A/B comparison: show the frame as decoded instead of the plugin output
+    void setShowOriginal(bool showOriginal);
+    bool isShowingOriginal() const;
+
     // Video controls
     bool loadVideo(const QString& videoPath);
     void play();
@@ -31,27 +53,87 @@ public:
     void forward(qint64 ms);
     void backward(qint64 ms);
 
+    // Playback speed (0.1x - 8x); frames that won't be shown are only grabbed
+    void setPlaybackRate(double rate);
+    double playbackRate() const;
+
+    // Below 1x, blend between consecutive frames instead of holding each one
+    void setSlowMotionInterpolation(bool enabled);
+    bool isSlowMotionInterpolation() const;
+
+    // Multi-view: follow a clock owned by the grid; this stream is at clock + offset
+    void setSharedClock(const MediaClock* clock);
+    void setTimeOffset(qint64 offsetMs);
+    qint64 timeOffset() const;
+
+    // Prefix of this view's frame counters (and its plugins'); set before loadVideo
+    void setMetricsScope(const QString& scope);
+    QString metricsScope() const;
+
+    // Only one view of a grid plays its audio
+    void setAudioEnabled(bool enabled);
+    bool isAudible() const;
+    qint64 audioPosition() const;
+
+    // Multi-view: decode the frame due at a clock time (any thread, one caller
+    // at a time), then show it from the UI thread. False once past the end.
+    bool decodeForClock(double clockMs);
+    void presentDecoded();
+
     // Getters
     bool isPlaying() const;
     qint64 position() const;
     qint64 duration() const;
     double getFps() const;
+    PresentationStats presentationStats() const;
+
+    // Latency of the frame path stages (decode, convert, plugins, upload)
+    QList<QPair<QString, LatencyStats>> pipelineLatencies() const;
+    void resetLatencyStats();
 
     // Plugin manager
     VideoPluginManager* pluginManager();
 
+    // Raw capture of the next frames as fed to the plugins (RGB), for replay
+    bool startRawCapture(const QString& path, int frameCount);
+    void stopRawCapture();
+    bool isRawCapturing() const;
+
+signals:
+    void rawCaptureFinished(const QString& path, qint64 frames);
+
+    // Time to present the next frame: on every swap, or from a timer while no swaps come
+    void presentationDue();
+
 protected:
     void initializeGL() override;
     void resizeGL(int w, int h) override;
     void paintGL() override;
 
 private slots:
-    void updateVideoFrame();
+    void onFrameSwapped();
+    void onFallbackTimer();
+    void updateClockSource();
 
 private:
     void createTexture();
     void deleteTexture();
+    void advancePresentation();
+    void presentNextFrame();
+    void presentInterpolated(double displayTime);
+    bool decodeFrame(qint64 targetFrame, cv::Mat& frame);
+    bool seekCapture(qint64 targetFrame);
+    cv::Mat convertFrame(const cv::Mat& frame, qint64 frameIndex);
+    cv::Mat prepareFrame(const cv::Mat& frame, qint64 frameIndex, OverlayCommandList& overlay);
+    void replayFrames(qint64 fromFrame, qint64 toFrame);
+    void showFrame(const cv::Mat& rgbFrame, qint64 frameIndex);
+    void resetInterpolation();
     void syncAudioToVideo();
+    qint64 framePts(qint64 frameIndex) const;
+    double clockMs() const;
+    void drawOverlayGeometry(const QRectF& videoRect);
+    void drawOverlayText(const QRectF& videoRect);
+    void captureRawFrame(const cv::Mat& rgbFrame, qint64 frameIndex);
 
     // OpenGL rendering
     GLuint m_textureId;
@@ -59,9 +141,20 @@ private:
     bool m_hasFrame;
     bool m_glInitialized;
 
+    // Vector overlays of the displayed frame
+    OverlayCommandList m_overlay;
+    bool m_overlayVisible;
+    bool m_showOriginal;
+    std::vector<GLfloat> m_overlayVertices; // Reused between frames
+    std::vector<GLubyte> m_overlayColors;
+
     // Video playback
     cv::VideoCapture m_videoCapture;
-    QTimer* m_frameTimer;
+    PresentationScheduler m_scheduler;
+    QTimer* m_fallbackTimer; // Drives presentation while hidden (no swaps)
+    QElapsedTimer m_swapTimer; // Since the last swap
+    MediaClock m_clock; // Drives presentation and position()
+    TimestampIndex m_timestamps; // Real PTS per frame, filled in the background
     QMediaPlayer* m_mediaPlayer;
     QAudioOutput* m_audioOutput;
 
@@ -69,11 +162,53 @@ private:
     double m_fps;
     qint64 m_totalFrames;
     qint64 m_currentFrameIndex;
+    double m_firstFrameMs; // Stream time of frame 0; index PTS count from it
     bool m_isPlaying;
     int m_syncCounter;
 
+    // Playback rate and slow motion blending
+    double m_playbackRate;
+    bool m_interpolate;
+    cv::Mat m_interpBase; // Processed frame at or before the clock
+    cv::Mat m_interpNext; // Processed frame after it
+    OverlayCommandList m_interpNextOverlay;
+    qint64 m_interpBaseIndex;
+    qint64 m_interpNextIndex;
+    cv::Mat m_blendBuffer;
+
+    // Multi-view: shared clock and the frame decoded for the next present
+    const MediaClock* m_sharedClock;
+    qint64 m_timeOffsetMs;
+    bool m_audioEnabled;
+    cv::Mat m_pendingFrame;
+    qint64 m_pendingIndex;
+    qint64 m_pendingSkipped;
+    double m_pendingTimeMs;
+
+    // Running cost estimates, to choose between grabbing and seeking ahead
+    double m_grabCostMs;
+    double m_seekCostMs;
+
+    // Frame path timing
+    LatencyHistogram m_decodeLatency;
+    LatencyHistogram m_convertLatency;
+    LatencyHistogram m_uploadLatency;
+
+    // Per-view metrics (owned by MetricsRegistry)
+    QString m_metricsScope;
+    MetricCounter* m_framesDecoded;
+    MetricCounter* m_framesPresented;
+    MetricCounter* m_framesDropped;
+    MetricGauge* m_presentLag;
+    MetricGauge* m_avDrift;
+    MemoryCharge m_decoderCharge; // Last decoded and displayed frames
+
     // Plugin system
     VideoPluginManager* m_pluginManager;
+
+    // Raw frame capture in progress, if any
+    std::unique_ptr<RawFrameWriter> m_rawCapture;
+    int m_rawCaptureRemaining;
 };
 
 #endif // VIDEOGLWIDGET_H
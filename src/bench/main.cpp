@@ -0,0 +1,130 @@
+#include "bench/perfgate.h"
+#include "bench/pipelinebenchmark.h"
+
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QFile>
+#include <QGuiApplication>
+#include <QJsonDocument>
+
+#include <algorithm>
+#include <cstdio>
+
+/**
+ * Frame pipeline microbenchmarks.
+ *
+ * Usage: blazestudio_bench [--iterations N] [--warmup N] [--filter TEXT]
+ *                          [--resolutions 720p,1080p,4K] [--replay FILE.bsraw]
+ *                          [--no-gl] [--output FILE]
+ *        blazestudio_bench --gate --baseline-dir DIR [--tolerance 0.25] [--update-baseline]
+ *                          [--require-baseline]
+ *
+ * Runs headless: without a QPA platform set, the offscreen one is used, so
+ * texture upload goes through Mesa (or any GL driver) without a display.
+ */
+
+namespace {
+
+bool parseResolutions(const QString& text, std::vector<cv::Size>& sizes)
+{
+    sizes.clear();
+    for (const QString& name : text.split(',', Qt::SkipEmptyParts)) {
+        const QString value = name.trimmed();
+        if (value == "720p") {
+            sizes.emplace_back(1280, 720);
+        } else if (value == "1080p") {
+            sizes.emplace_back(1920, 1080);
+        } else if (value.compare("4K", Qt::CaseInsensitive) == 0) {
+            sizes.emplace_back(3840, 2160);
+        } else {
+            const QStringList parts = value.split('x');
+            bool widthOk = false;
+            bool heightOk = false;
+            if (parts.size() != 2) {
+                return false;
+            }
+            const int width = parts[0].toInt(&widthOk);
+            const int height = parts[1].toInt(&heightOk);
+            if (!widthOk || !heightOk || width <= 0 || height <= 0) {
+                return false;
+            }
+            sizes.emplace_back(width, height);
+        }
+    }
+    return !sizes.empty();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Frame pipeline microbenchmarks on synthetic video");
+    parser.addHelpOption();
+    parser.addOption(QCommandLineOption("iterations", "Timed runs per benchmark", "count", "100"));
+    parser.addOption(QCommandLineOption("warmup", "Untimed runs per benchmark", "count", "10"));
+    parser.addOption(QCommandLineOption("filter", "Only run benchmarks whose name contains one of these "
+                                        "comma separated texts", "list"));
+    parser.addOption(QCommandLineOption("resolutions", "Comma separated: 720p, 1080p, 4K or WxH",
+                                        "list", "720p,1080p,4K"));
+    parser.addOption(QCommandLineOption("replay", "Use the frames of a raw capture instead of synthetic clips",
+                                        "file"));
+    parser.addOption(QCommandLineOption("no-gl", "Skip the texture upload benchmark"));
+    parser.addOption(QCommandLineOption("output", "Write JSON results to file instead of stdout", "file"));
+    parser.addOption(QCommandLineOption("gate", "Compare the gated scenarios with this machine's baseline"));
+    parser.addOption(QCommandLineOption("baseline-dir", "Directory of per-machine baseline files", "dir", "."));
+    parser.addOption(QCommandLineOption("tolerance", "Allowed relative regression (gate)", "fraction", "0.25"));
+    parser.addOption(QCommandLineOption("update-baseline", "Record this run as the new baseline (gate)"));
+    parser.addOption(QCommandLineOption("require-baseline", "Fail when this machine has no baseline yet (gate)"));
+    parser.process(app);
+
+    if (parser.isSet("gate")) {
+        PerfGate::Options gateOptions;
+        gateOptions.baselineDir = parser.value("baseline-dir");
+        gateOptions.tolerance = std::max(0.0, parser.value("tolerance").toDouble());
+        gateOptions.updateBaseline = parser.isSet("update-baseline");
+        gateOptions.requireBaseline = parser.isSet("require-baseline");
+        if (parser.isSet("iterations")) {
+            gateOptions.iterations = std::max(1, parser.value("iterations").toInt());
+        }
+
+        PerfGate gate(gateOptions);
+        return gate.run() ? 0 : 1;
+    }
+
+    PipelineBenchmark::Options options;
+    options.iterations = std::max(1, parser.value("iterations").toInt());
+    options.warmup = std::max(0, parser.value("warmup").toInt());
+    options.filters = parser.value("filter").split(',', Qt::SkipEmptyParts);
+    options.textureUpload = !parser.isSet("no-gl");
+    options.replayPath = parser.value("replay");
+    if (!parseResolutions(parser.value("resolutions"), options.resolutions)) {
+        qWarning() << "[Bench] Invalid resolutions:" << parser.value("resolutions");
+        return 1;
+    }
+
+    PipelineBenchmark benchmark(options);
+    const QList<BenchmarkResult> results = benchmark.run();
+
+    const QByteArray json = QJsonDocument(PipelineBenchmark::toJson(results)).toJson(QJsonDocument::Indented);
+
+    if (parser.isSet("output")) {
+        QFile file(parser.value("output"));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            qWarning() << "[Bench] Cannot write" << file.fileName() << ":" << file.errorString();
+            return 1;
+        }
+        file.write(json);
+        qDebug() << "[Bench] Results written to" << file.fileName();
+    } else {
+        fwrite(json.constData(), 1, static_cast<size_t>(json.size()), stdout);
+    }
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include "bench/perfgate.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QSysInfo>
+
+PerfGate::PerfGate(const Options& options)
+    : m_options(options)
+{
+}
+
+QStringList PerfGate::scenarios()
+{
+    // A pose scenario belongs here once a pose plugin exists
+    return {QStringLiteral("decode.mjpeg"), QStringLiteral("manager.edge_overlay")};
+}
+
+bool PerfGate::run()
+{
+    m_outcomes.clear();
+
+    PipelineBenchmark::Options benchOptions;
+    benchOptions.iterations = m_options.iterations;
+    benchOptions.warmup = m_options.warmup;
+    benchOptions.filters = scenarios();
+    benchOptions.textureUpload = false;
+    benchOptions.resolutions = {cv::Size(1280, 720), cv::Size(1920, 1080)};
+
+    PipelineBenchmark benchmark(benchOptions);
+    const QList<BenchmarkResult> results = benchmark.run();
+    if (results.isEmpty()) {
+        qWarning() << "[PerfGate] No scenario produced results";
+        return false;
+    }
+
+    QJsonObject baseline;
+    const bool hasBaseline = !m_options.updateBaseline && loadBaseline(baseline);
+
+    // Scenarios without a reference (new ones, or all on a new machine) are recorded
+    QJsonObject recorded = baseline;
+    int added = 0;
+
+    bool passed = true;
+    for (const BenchmarkResult& result : results) {
+        GateOutcome outcome;
+        outcome.key = keyFor(result);
+        outcome.framesPerSecond = result.framesPerSecond;
+        outcome.p99Ms = result.stats.p99Ms;
+
+        const QJsonObject reference = baseline.value(outcome.key).toObject();
+        if (!reference.isEmpty()) {
+            outcome.hasBaseline = true;
+            outcome.baselineFramesPerSecond = reference.value("fps").toDouble();
+            outcome.baselineP99Ms = reference.value("p99Ms").toDouble();
+            outcome.regressed =
+                outcome.framesPerSecond < outcome.baselineFramesPerSecond * (1.0 - m_options.tolerance)
+                || outcome.p99Ms > outcome.baselineP99Ms * (1.0 + m_options.tolerance);
+            passed = passed && !outcome.regressed;
+        } else {
+            QJsonObject entry;
+            entry["fps"] = result.framesPerSecond;
+            entry["p99Ms"] = result.stats.p99Ms;
+            recorded[outcome.key] = entry;
+            ++added;
+        }
+        m_outcomes.append(outcome);
+    }
+
+    report();
+
+    if (added > 0) {
+        if (!saveBaseline(recorded)) {
+            return false;
+        }
+        qInfo().noquote() << "[PerfGate] Recorded" << added << "scenarios in" << baselinePath();
+    }
+
+    if (!hasBaseline && !m_options.updateBaseline) {
+        qWarning().noquote() << "[PerfGate] WARNING: no baseline for this machine in" << m_options.baselineDir
+                             << "- nothing was gated. The run was recorded; commit the file or keep the"
+                             << "directory between runs for the gate to mean anything.";
+        if (m_options.requireBaseline) {
+            return false;
+        }
+    }
+
+    return passed;
+}
+
+QList<GateOutcome> PerfGate::outcomes() const
+{
+    return m_outcomes;
+}
+
+QString PerfGate::baselinePath() const
+{
+    // Host names can contain characters that are awkward in file names
+    QString host = QSysInfo::machineHostName();
+    host.replace(QRegularExpression("[^A-Za-z0-9._-]"), "_");
+    if (host.isEmpty()) {
+        host = QStringLiteral("unknown-host");
+    }
+    return QDir(m_options.baselineDir).filePath(host + ".json");
+}
+
+QString PerfGate::keyFor(const BenchmarkResult& result)
+{
+    return result.name + "@" + result.resolution;
+}
+
+bool PerfGate::loadBaseline(QJsonObject& scenarios) const
+{
+    QFile file(baselinePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError) {
+        qWarning() << "[PerfGate] Ignoring unreadable baseline" << file.fileName() << ":" << error.errorString();
+        return false;
+    }
+
+    scenarios = document.object().value("scenarios").toObject();
+    return !scenarios.isEmpty();
+}
+
+bool PerfGate::saveBaseline(const QJsonObject& scenarios) const
+{
+    QJsonObject root;
+    root["machine"] = PipelineBenchmark::machineInfo();
+    root["scenarios"] = scenarios;
+
+    if (!QDir().mkpath(m_options.baselineDir)) {
+        qWarning() << "[PerfGate] Cannot create" << m_options.baselineDir;
+        return false;
+    }
+
+    QFile file(baselinePath());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "[PerfGate] Cannot write baseline" << file.fileName() << ":" << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+void PerfGate::report() const
+{
+    qInfo().noquote() << QString("[PerfGate] Tolerance %1%").arg(m_options.tolerance * 100.0, 0, 'f', 0);
+
+    for (const GateOutcome& outcome : m_outcomes) {
+        QString line = QString("[PerfGate] %1: %2 fps, p99 %3 ms")
+                           .arg(outcome.key, -28)
+                           .arg(outcome.framesPerSecond, 0, 'f', 1)
+                           .arg(outcome.p99Ms, 0, 'f', 2);
+        if (!outcome.hasBaseline) {
+            line += " (no baseline)";
+        } else {
+            line += QString(" (baseline %1 fps, p99 %2 ms)%3")
+                        .arg(outcome.baselineFramesPerSecond, 0, 'f', 1)
+                        .arg(outcome.baselineP99Ms, 0, 'f', 2)
+                        .arg(outcome.regressed ? " REGRESSED" : "");
+        }
+
+        if (outcome.regressed) {
+            qWarning().noquote() << line;
+        } else {
+            qInfo().noquote() << line;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#include "core/decodepool.h"
+#include "core/tracing.h"
+#include <QDebug>
+#include <QSemaphore>
+#include <QThread>
+#include <algorithm>
+
+namespace {
+
+// Enough for a four-angle session; more only adds contention on memory bandwidth
+const int kMaxDecodeThreads = 4;
+
+// Decoders are cheap to keep; recreating threads between ticks is not
+const int kThreadExpiryMs = 30000;
+
+} // namespace
+
+DecodePool::DecodePool(int maxThreads)
+{
+    // The UI thread also decodes, so leave it a core
+    if (maxThreads <= 0) {
+        maxThreads = qBound(1, QThread::idealThreadCount() - 1, kMaxDecodeThreads);
+    }
+    m_pool.setMaxThreadCount(maxThreads);
+    m_pool.setExpiryTimeout(kThreadExpiryMs);
+
+    qDebug() << "[DecodePool]" << maxThreads << "decode threads";
+}
+
+DecodePool::~DecodePool()
+{
+    m_pool.waitForDone();
+}
+
+int DecodePool::maxThreadCount() const
+{
+    return m_pool.maxThreadCount();
+}
+
+void DecodePool::runAll(const std::vector<std::function<void()>>& jobs)
+{
+    if (jobs.empty()) {
+        return;
+    }
+
+    QSemaphore finished;
+    const int queued = static_cast<int>(jobs.size()) - 1;
+    for (int i = 0; i < queued; ++i) {
+        const std::function<void()>& job = jobs[static_cast<size_t>(i)];
+        m_pool.start([&job, &finished]() {
+            static thread_local bool named = false;
+            if (!named) {
+                Tracer::setThreadName(QStringLiteral("decode"));
+                named = true;
+            }
+            job();
+            finished.release();
+        });
+    }
+
+    jobs.back()();
+    finished.acquire(queued);
+}
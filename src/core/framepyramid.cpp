@@ -0,0 +1,115 @@
+#include "core/framepyramid.h"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+
+namespace {
+
+// Levels below this size are useless for any plugin
+const int kMinimumLevelDimension = 16;
+
+} // namespace
+
+FramePyramid::FramePyramid()
+    : m_builtLevels(0)
+    , m_charge(MemorySubsystem::PluginScratch)
+{
+}
+
+void FramePyramid::reset(const cv::Mat& base)
+{
+    if (m_levels.empty()) {
+        m_levels.resize(1);
+    }
+
+    // Keep buffers of the other levels so resize can reuse their memory,
+    // unless someone downstream still holds last frame's level
+    for (size_t i = 1; i < m_levels.size(); ++i) {
+        if (m_levels[i].u && m_levels[i].u->refcount > 1) {
+            m_levels[i].release();
+        }
+    }
+
+    m_levels[0] = base;
+    m_builtLevels = base.empty() ? 0 : 1;
+    updateCharge();
+}
+
+cv::Mat& FramePyramid::levelFor(const cv::Size& minimum)
+{
+    int index = levelIndexFor(minimum);
+
+    if (index >= static_cast<int>(m_levels.size())) {
+        m_levels.resize(index + 1);
+    }
+
+    // Each level is downsampled from the previous one, which is cheaper than
+    // going from the base every time and keeps INTER_AREA quality
+    while (m_builtLevels <= index) {
+        const cv::Mat& previous = m_levels[m_builtLevels - 1];
+        cv::resize(previous, m_levels[m_builtLevels],
+                   levelSize(m_levels[0].size(), m_builtLevels), 0, 0, cv::INTER_AREA);
+        ++m_builtLevels;
+        updateCharge();
+    }
+
+    return m_levels[index];
+}
+
+cv::Size FramePyramid::levelSizeFor(const cv::Size& minimum) const
+{
+    if (m_builtLevels == 0) {
+        return cv::Size();
+    }
+    return levelSize(m_levels[0].size(), levelIndexFor(minimum));
+}
+
+int FramePyramid::builtLevels() const
+{
+    return m_builtLevels;
+}
+
+bool FramePyramid::holds(const cv::Mat& mat) const
+{
+    if (!mat.u) {
+        return false;
+    }
+    for (int i = 0; i < m_builtLevels; ++i) {
+        if (m_levels[i].u == mat.u) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int FramePyramid::levelIndexFor(const cv::Size& minimum) const
+{
+    if (m_builtLevels == 0 || minimum.width <= 0 || minimum.height <= 0) {
+        return 0;
+    }
+
+    const cv::Size base = m_levels[0].size();
+    int index = 0;
+    while (true) {
+        cv::Size next = levelSize(base, index + 1);
+        if (next.width < minimum.width || next.height < minimum.height
+            || next.width < kMinimumLevelDimension || next.height < kMinimumLevelDimension) {
+            break;
+        }
+        ++index;
+    }
+    return index;
+}
+
+cv::Size FramePyramid::levelSize(const cv::Size& base, int level)
+{
+    return cv::Size(std::max(1, base.width >> level), std::max(1, base.height >> level));
+}
+
+void FramePyramid::updateCharge()
+{
+    qint64 bytes = 0;
+    for (size_t i = 1; i < m_levels.size(); ++i) {
+        bytes += static_cast<qint64>(m_levels[i].total() * m_levels[i].elemSize());
+    }
+    m_charge.set(bytes);
+}
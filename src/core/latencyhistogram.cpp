@@ -0,0 +1,95 @@
+#include "core/latencyhistogram.h"
+#include <QtAlgorithms>
+#include <algorithm>
+
+LatencyHistogram::LatencyHistogram()
+    : m_totalNs(0)
+    , m_maxNs(0)
+{
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::record(qint64 nanoseconds)
+{
+    nanoseconds = std::max<qint64>(0, nanoseconds);
+
+    m_buckets[bucketFor(nanoseconds / 1000)].fetch_add(1, std::memory_order_relaxed);
+    m_totalNs.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    qint64 currentMax = m_maxNs.load(std::memory_order_relaxed);
+    while (nanoseconds > currentMax
+           && !m_maxNs.compare_exchange_weak(currentMax, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+LatencyStats LatencyHistogram::stats() const
+{
+    // Copy first so percentiles are computed on one consistent set of counts
+    std::array<quint64, kBucketCount> counts;
+    quint64 total = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    LatencyStats result;
+    if (total == 0) {
+        return result;
+    }
+
+    result.count = static_cast<qint64>(total);
+    result.meanMs = m_totalNs.load(std::memory_order_relaxed) / 1e6 / total;
+    result.maxMs = m_maxNs.load(std::memory_order_relaxed) / 1e6;
+
+    const double quantiles[3] = {0.50, 0.95, 0.99};
+    double* targets[3] = {&result.p50Ms, &result.p95Ms, &result.p99Ms};
+
+    quint64 seen = 0;
+    int next = 0;
+    for (int i = 0; i < kBucketCount && next < 3; ++i) {
+        seen += counts[i];
+        while (next < 3 && seen >= quantiles[next] * total) {
+            // Never report a percentile above the exact maximum
+            *targets[next] = std::min(bucketMidpointMs(i), result.maxMs);
+            ++next;
+        }
+    }
+
+    return result;
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_totalNs.store(0, std::memory_order_relaxed);
+    m_maxNs.store(0, std::memory_order_relaxed);
+}
+
+int LatencyHistogram::bucketFor(qint64 microseconds)
+{
+    // Below 4 us every microsecond gets its own bucket
+    if (microseconds < kSubBuckets) {
+        return static_cast<int>(microseconds);
+    }
+
+    int exponent = 63 - static_cast<int>(qCountLeadingZeroBits(static_cast<quint64>(microseconds)));
+    int sub = static_cast<int>((microseconds >> (exponent - 2)) & (kSubBuckets - 1));
+    return std::min(kBucketCount - 1, kSubBuckets + (exponent - 2) * kSubBuckets + sub);
+}
+
+double LatencyHistogram::bucketMidpointMs(int bucket)
+{
+    if (bucket < kSubBuckets) {
+        return (bucket + 0.5) / 1000.0;
+    }
+
+    int exponent = (bucket - kSubBuckets) / kSubBuckets + 2;
+    int sub = (bucket - kSubBuckets) % kSubBuckets;
+    double width = static_cast<double>(1LL << (exponent - 2));
+    double lower = static_cast<double>(1LL << exponent) + sub * width;
+    return (lower + width * 0.5) / 1000.0;
+}
@@ -0,0 +1,241 @@
+#include "core/logger.h"
+#include "core/metricsregistry.h"
+#include <QDebug>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+// Drain thread wakes up at least this often even if nobody signals it
+const int kDrainIntervalMs = 50;
+
+qint64 steadyNowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+bool LogSite::admit()
+{
+    const qint64 now = steadyNowMs();
+    qint64 windowStart = m_windowStartMs.load(std::memory_order_relaxed);
+
+    if (now - windowStart >= 1000) {
+        // First message of a new window: whoever wins the exchange resets the count
+        if (m_windowStartMs.compare_exchange_strong(windowStart, now, std::memory_order_relaxed)) {
+            m_windowCount.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    if (m_windowCount.fetch_add(1, std::memory_order_relaxed) < kMessagesPerSecond) {
+        return true;
+    }
+
+    m_suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+Logger& Logger::instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : m_cells(new Cell[kCapacity])
+    , m_enqueuePos(0)
+    , m_dequeuePos(0)
+    , m_dropped(0)
+    , m_sleeping(false)
+    , m_running(true)
+    , m_written(0)
+{
+    for (size_t i = 0; i < kCapacity; ++i) {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_thread = std::thread(&Logger::run, this);
+}
+
+Logger::~Logger()
+{
+    m_running.store(false, std::memory_order_release);
+    m_wake.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void Logger::flush()
+{
+    const quint64 target = m_enqueuePos.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    m_wake.notify_one();
+    m_drained.wait_for(lock, std::chrono::seconds(2), [&] {
+        return m_written.load(std::memory_order_acquire) >= target;
+    });
+}
+
+qint64 Logger::droppedMessages() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+void Logger::captureText(Record& record, Arg& arg, const char* text, size_t length)
+{
+    const size_t available = static_cast<size_t>(kTextBytes - record.textUsed);
+    length = std::min(length, available);
+
+    arg.type = ArgType::Text;
+    arg.text.offset = static_cast<quint16>(record.textUsed);
+    arg.text.length = static_cast<quint16>(length);
+    std::memcpy(record.text + record.textUsed, text, length);
+    record.textUsed += static_cast<int>(length);
+}
+
+void Logger::push(const Record& record)
+{
+    size_t position = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = m_cells[position & (kCapacity - 1)];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+        if (difference == 0) {
+            if (m_enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                cell.record = record;
+                cell.sequence.store(position + 1, std::memory_order_release);
+                break;
+            }
+        } else if (difference < 0) {
+            // Full: drop rather than stall the frame path
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            position = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    if (m_sleeping.load(std::memory_order_relaxed)) {
+        m_wake.notify_one();
+    }
+}
+
+bool Logger::pop(Record& record)
+{
+    size_t position = m_dequeuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = m_cells[position & (kCapacity - 1)];
+        const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+        if (difference == 0) {
+            if (m_dequeuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                record = cell.record;
+                cell.sequence.store(position + kCapacity, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            return false;
+        } else {
+            position = m_dequeuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::run()
+{
+    MetricGauge& queueDepth = MetricsRegistry::instance().gauge(MetricNames::LogQueueDepth);
+    MetricGauge& dropped = MetricsRegistry::instance().gauge(MetricNames::LogDropped);
+
+    Record record;
+    for (;;) {
+        queueDepth.set(static_cast<double>(m_enqueuePos.load(std::memory_order_relaxed)
+                                           - m_dequeuePos.load(std::memory_order_relaxed)));
+        dropped.set(static_cast<double>(m_dropped.load(std::memory_order_relaxed)));
+
+        bool wrote = false;
+        while (pop(record)) {
+            write(record);
+            m_written.fetch_add(1, std::memory_order_release);
+            wrote = true;
+        }
+
+        if (wrote) {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_drained.notify_all();
+        }
+
+        if (!m_running.load(std::memory_order_acquire)) {
+            // Last pass after shutdown was requested
+            while (pop(record)) {
+                write(record);
+            }
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_sleeping.store(true, std::memory_order_relaxed);
+        m_wake.wait_for(lock, std::chrono::milliseconds(kDrainIntervalMs));
+        m_sleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+void Logger::write(const Record& record) const
+{
+    // Built as UTF-8 bytes; formats and text arguments are UTF-8 too
+    QByteArray message;
+    message.reserve(128);
+    message += '[';
+    message += record.site->category;
+    message += "] ";
+
+    // Expand %1..%8; anything else is copied as is
+    for (const char* c = record.format; *c; ++c) {
+        if (c[0] == '%' && c[1] >= '1' && c[1] <= '9' && c[1] - '1' < record.argCount) {
+            const Arg& arg = record.args[c[1] - '1'];
+            switch (arg.type) {
+            case ArgType::Int:
+                message += QByteArray::number(arg.i);
+                break;
+            case ArgType::UInt:
+                message += QByteArray::number(arg.u);
+                break;
+            case ArgType::Double:
+                message += QByteArray::number(arg.d);
+                break;
+            case ArgType::Bool:
+                message += arg.u ? "true" : "false";
+                break;
+            case ArgType::Text:
+                message.append(record.text + arg.text.offset, arg.text.length);
+                break;
+            }
+            ++c;
+        } else {
+            message += *c;
+        }
+    }
+
+    if (record.suppressed > 0) {
+        message += " (" + QByteArray::number(record.suppressed) + " similar messages suppressed)";
+    }
+
+    const QString text = QString::fromUtf8(message);
+    switch (record.site->level) {
+    case LogLevel::Trace:
+    case LogLevel::Debug:
+        qDebug().noquote() << text;
+        break;
+    case LogLevel::Info:
+        qInfo().noquote() << text;
+        break;
+    case LogLevel::Warning:
+        qWarning().noquote() << text;
+        break;
+    case LogLevel::Error:
+        qCritical().noquote() << text;
+        break;
+    }
+}
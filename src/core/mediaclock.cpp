@@ -0,0 +1,153 @@
+#include "core/mediaclock.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Errors above this are a discontinuity (seek, stall), not drift
+const double kResyncThresholdMs = 120.0;
+
+// Drift is removed over about this much time, never faster than kMaxSlew
+const double kCorrectionWindowMs = 1000.0;
+const double kMaxSlew = 0.03;
+
+// Audio reports are quantized; below this the clock is left alone
+const double kDeadbandMs = 2.0;
+
+// Weight of a new error sample in the filtered error
+const double kErrorSmoothing = 0.2;
+
+// The player may still report the old position right after start/seek
+const qint64 kSettleNs = 150 * 1000 * 1000;
+
+} // namespace
+
+MediaClock::MediaClock()
+    : m_source(Source::FreeRun)
+    , m_running(false)
+    , m_rate(1.0)
+    , m_anchorMs(0.0)
+    , m_anchorNs(0)
+    , m_slew(0.0)
+    , m_filteredErrorMs(0.0)
+    , m_driftMs(0.0)
+    , m_lastAudioMs(-1)
+    , m_settleUntilNs(0)
+{
+    m_timer.start();
+}
+
+void MediaClock::setSource(Source source)
+{
+    if (source == m_source) {
+        return;
+    }
+    anchor(nowMs());
+    m_source = source;
+    m_lastAudioMs = -1;
+}
+
+MediaClock::Source MediaClock::source() const
+{
+    return m_source;
+}
+
+void MediaClock::start(double positionMs)
+{
+    anchor(positionMs);
+    m_running = true;
+    m_lastAudioMs = -1;
+    m_settleUntilNs = m_timer.nsecsElapsed() + kSettleNs;
+}
+
+void MediaClock::pause()
+{
+    if (!m_running) {
+        return;
+    }
+    anchor(nowMs());
+    m_running = false;
+}
+
+void MediaClock::seek(double positionMs)
+{
+    anchor(positionMs);
+    m_lastAudioMs = -1;
+    m_settleUntilNs = m_timer.nsecsElapsed() + kSettleNs;
+}
+
+bool MediaClock::isRunning() const
+{
+    return m_running;
+}
+
+void MediaClock::setRate(double rate)
+{
+    if (rate <= 0.0 || rate == m_rate) {
+        return;
+    }
+    // Continue from where the old rate got to
+    const double position = nowMs();
+    m_rate = rate;
+    m_anchorMs = position;
+    m_anchorNs = m_timer.nsecsElapsed();
+}
+
+double MediaClock::rate() const
+{
+    return m_rate;
+}
+
+void MediaClock::updateAudio(qint64 audioPositionMs)
+{
+    if (m_source != Source::Audio || !m_running || audioPositionMs == m_lastAudioMs) {
+        return;
+    }
+    m_lastAudioMs = audioPositionMs;
+    if (m_timer.nsecsElapsed() < m_settleUntilNs) {
+        return;
+    }
+
+    const double now = nowMs();
+    const double error = audioPositionMs - now;
+    m_driftMs = error;
+
+    if (std::abs(error) > kResyncThresholdMs) {
+        anchor(audioPositionMs);
+        return;
+    }
+
+    // Re-anchor at the current position so changing the slew never makes the clock jump
+    m_filteredErrorMs += (error - m_filteredErrorMs) * kErrorSmoothing;
+    m_anchorMs = now;
+    m_anchorNs = m_timer.nsecsElapsed();
+    m_slew = std::abs(m_filteredErrorMs) < kDeadbandMs
+                 ? 0.0
+                 : qBound(-kMaxSlew, m_filteredErrorMs / kCorrectionWindowMs, kMaxSlew);
+}
+
+double MediaClock::nowMs() const
+{
+    if (!m_running) {
+        return m_anchorMs;
+    }
+    return std::max(0.0, m_anchorMs + elapsedSinceAnchorMs() * m_rate * (1.0 + m_slew));
+}
+
+double MediaClock::driftMs() const
+{
+    return m_driftMs;
+}
+
+void MediaClock::anchor(double positionMs)
+{
+    m_anchorMs = std::max(0.0, positionMs);
+    m_anchorNs = m_timer.nsecsElapsed();
+    m_slew = 0.0;
+    m_filteredErrorMs = 0.0;
+}
+
+double MediaClock::elapsedSinceAnchorMs() const
+{
+    return (m_timer.nsecsElapsed() - m_anchorNs) / 1e6;
+}
@@ -0,0 +1,172 @@
+#include "core/memoryaccountant.h"
+#include "core/logger.h"
+#include "core/metricsregistry.h"
+
+namespace {
+
+const qint64 kDefaultBudgetMb = 4096;
+const double kEvictFraction = 0.8;
+const double kThrottleFraction = 0.9;
+
+} // namespace
+
+MemoryAccountant& MemoryAccountant::instance()
+{
+    static MemoryAccountant accountant;
+    return accountant;
+}
+
+MemoryAccountant::MemoryAccountant()
+    : m_total(0)
+    , m_peakTotal(0)
+    , m_budget(0)
+    , m_overBudget(false)
+{
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    for (int i = 0; i < kSubsystemCount; ++i) {
+        m_current[i].store(0, std::memory_order_relaxed);
+        m_peak[i].store(0, std::memory_order_relaxed);
+
+        const QString prefix = QStringLiteral("memory.%1.").arg(subsystemName(static_cast<MemorySubsystem>(i)));
+        m_currentGauges[i] = &registry.gauge(prefix + "current_bytes");
+        m_peakGauges[i] = &registry.gauge(prefix + "peak_bytes");
+    }
+    m_totalGauge = &registry.gauge(MetricNames::MemoryTotal);
+    m_peakTotalGauge = &registry.gauge(MetricNames::MemoryPeak);
+    m_budgetGauge = &registry.gauge(MetricNames::MemoryBudget);
+
+    bool ok = false;
+    qint64 budgetMb = qEnvironmentVariableIntValue("BLAZESTUDIO_MEMORY_BUDGET_MB", &ok);
+    setBudget((ok ? qMax<qint64>(0, budgetMb) : kDefaultBudgetMb) * 1024 * 1024);
+}
+
+void MemoryAccountant::add(MemorySubsystem subsystem, qint64 delta)
+{
+    if (delta == 0) {
+        return;
+    }
+
+    const int index = static_cast<int>(subsystem);
+    const qint64 current = m_current[index].fetch_add(delta, std::memory_order_relaxed) + delta;
+    const qint64 total = m_total.fetch_add(delta, std::memory_order_relaxed) + delta;
+    m_currentGauges[index]->set(static_cast<double>(current));
+    m_totalGauge->set(static_cast<double>(total));
+
+    if (delta < 0) {
+        if (!above(1.0)) {
+            m_overBudget.store(false, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    raisePeak(m_peak[index], current);
+    raisePeak(m_peakTotal, total);
+    m_peakGauges[index]->set(static_cast<double>(m_peak[index].load(std::memory_order_relaxed)));
+    m_peakTotalGauge->set(static_cast<double>(m_peakTotal.load(std::memory_order_relaxed)));
+
+    if (above(1.0) && !m_overBudget.exchange(true, std::memory_order_relaxed)) {
+        LOG_WARNING("MemoryAccountant", "Over budget: %1 MB accounted, budget %2 MB (%3 holds %4 MB)",
+                    total / (1024 * 1024), budget() / (1024 * 1024),
+                    subsystemName(subsystem), current / (1024 * 1024));
+    }
+}
+
+qint64 MemoryAccountant::current(MemorySubsystem subsystem) const
+{
+    return m_current[static_cast<int>(subsystem)].load(std::memory_order_relaxed);
+}
+
+qint64 MemoryAccountant::peak(MemorySubsystem subsystem) const
+{
+    return m_peak[static_cast<int>(subsystem)].load(std::memory_order_relaxed);
+}
+
+qint64 MemoryAccountant::total() const
+{
+    return m_total.load(std::memory_order_relaxed);
+}
+
+qint64 MemoryAccountant::peakTotal() const
+{
+    return m_peakTotal.load(std::memory_order_relaxed);
+}
+
+void MemoryAccountant::setBudget(qint64 bytes)
+{
+    m_budget.store(qMax<qint64>(0, bytes), std::memory_order_relaxed);
+    m_budgetGauge->set(static_cast<double>(budget()));
+}
+
+qint64 MemoryAccountant::budget() const
+{
+    return m_budget.load(std::memory_order_relaxed);
+}
+
+bool MemoryAccountant::shouldEvict() const
+{
+    return above(kEvictFraction);
+}
+
+bool MemoryAccountant::shouldThrottle() const
+{
+    return above(kThrottleFraction);
+}
+
+const char* MemoryAccountant::subsystemName(MemorySubsystem subsystem)
+{
+    switch (subsystem) {
+    case MemorySubsystem::DecoderBuffers:
+        return "decoder";
+    case MemorySubsystem::FramePools:
+        return "frame_pools";
+    case MemorySubsystem::Caches:
+        return "caches";
+    case MemorySubsystem::PluginScratch:
+        return "plugin_scratch";
+    case MemorySubsystem::InferenceArenas:
+        return "inference_arenas";
+    case MemorySubsystem::Count:
+        break;
+    }
+    return "unknown";
+}
+
+bool MemoryAccountant::above(double fraction) const
+{
+    const qint64 limit = budget();
+    return limit > 0 && total() > static_cast<qint64>(limit * fraction);
+}
+
+void MemoryAccountant::raisePeak(std::atomic<qint64>& peak, qint64 value)
+{
+    qint64 previous = peak.load(std::memory_order_relaxed);
+    while (value > previous
+           && !peak.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {
+    }
+}
+
+MemoryCharge::MemoryCharge(MemorySubsystem subsystem)
+    : m_subsystem(subsystem)
+    , m_bytes(0)
+{
+}
+
+MemoryCharge::~MemoryCharge()
+{
+    set(0);
+}
+
+void MemoryCharge::set(qint64 bytes)
+{
+    bytes = qMax<qint64>(0, bytes);
+    if (bytes == m_bytes) {
+        return;
+    }
+    MemoryAccountant::instance().add(m_subsystem, bytes - m_bytes);
+    m_bytes = bytes;
+}
+
+qint64 MemoryCharge::bytes() const
+{
+    return m_bytes;
+}
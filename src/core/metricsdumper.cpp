@@ -0,0 +1,66 @@
+#include "core/metricsdumper.h"
+#include "core/metricsregistry.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+MetricsDumper::MetricsDumper(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_timer, &QTimer::timeout, this, &MetricsDumper::dump);
+}
+
+MetricsDumper::~MetricsDumper()
+{
+    stop();
+}
+
+bool MetricsDumper::start(const QString& path, int intervalMs)
+{
+    stop();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "[MetricsDumper] Cannot open" << path << ":" << m_file.errorString();
+        return false;
+    }
+
+    m_timer.start(qMax(10, intervalMs));
+    qDebug() << "[MetricsDumper] Writing metrics to" << path << "every" << m_timer.interval() << "ms";
+    return true;
+}
+
+void MetricsDumper::stop()
+{
+    if (!m_timer.isActive()) {
+        return;
+    }
+
+    m_timer.stop();
+    dump(); // Final values
+    m_file.close();
+}
+
+bool MetricsDumper::isRunning() const
+{
+    return m_timer.isActive();
+}
+
+void MetricsDumper::dump()
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    registry.sampleProcess();
+
+    QJsonObject line;
+    line["time"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+    line["metrics"] = registry.snapshot().toJson();
+
+    m_file.write(QJsonDocument(line).toJson(QJsonDocument::Compact));
+    m_file.write("\n");
+    m_file.flush();
+}
@@ -0,0 +1,168 @@
+#include "core/metricsregistry.h"
+#include <QDebug>
+#include <QMutexLocker>
+#include <chrono>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#else
+#include <cstdio>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const qint64 kProcessSampleIntervalMs = 500;
+
+qint64 steadyNowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+double MetricsSnapshot::value(const QString& name, double fallback) const
+{
+    for (const Value& entry : values) {
+        if (*entry.name == name) {
+            return entry.value;
+        }
+    }
+    return fallback;
+}
+
+double MetricsSnapshot::rate(const QString& name, const MetricsSnapshot& earlier) const
+{
+    const qint64 elapsedMs = timestampMs - earlier.timestampMs;
+    if (elapsedMs <= 0) {
+        return 0.0;
+    }
+    return (value(name) - earlier.value(name)) * 1000.0 / elapsedMs;
+}
+
+QJsonObject MetricsSnapshot::toJson() const
+{
+    QJsonObject object;
+    for (const Value& entry : values) {
+        object[*entry.name] = entry.value;
+    }
+    return object;
+}
+
+MetricsRegistry& MetricsRegistry::instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+MetricsRegistry::MetricsRegistry()
+    : m_entries(new Entry[kMaxMetrics])
+    , m_count(0)
+    , m_lastProcessSampleMs(0)
+{
+}
+
+MetricCounter& MetricsRegistry::counter(const QString& name)
+{
+    return entry(name, MetricKind::Counter).counter;
+}
+
+MetricGauge& MetricsRegistry::gauge(const QString& name)
+{
+    return entry(name, MetricKind::Gauge).gauge;
+}
+
+MetricsRegistry::Entry& MetricsRegistry::entry(const QString& name, MetricKind kind)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_index.constFind(name);
+    if (it != m_index.constEnd()) {
+        Entry& existing = m_entries[*it];
+        if (existing.kind != kind) {
+            qWarning() << "[MetricsRegistry] Metric registered with another kind:" << name;
+        }
+        return existing;
+    }
+
+    const int index = m_count.load(std::memory_order_relaxed);
+    if (index >= kMaxMetrics) {
+        qWarning() << "[MetricsRegistry] Too many metrics, not recording" << name;
+        return m_overflow;
+    }
+
+    // Filled in before the count publishes it to snapshot()
+    Entry& created = m_entries[index];
+    created.name = name;
+    created.kind = kind;
+    m_index.insert(name, index);
+    m_count.store(index + 1, std::memory_order_release);
+    return created;
+}
+
+MetricsSnapshot MetricsRegistry::snapshot() const
+{
+    MetricsSnapshot result;
+    result.timestampMs = steadyNowMs();
+
+    const int count = m_count.load(std::memory_order_acquire);
+    result.values.reserve(static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        const Entry& entry = m_entries[i];
+        const double value = entry.kind == MetricKind::Counter ? static_cast<double>(entry.counter.value())
+                                                               : entry.gauge.value();
+        result.values.push_back({&entry.name, entry.kind, value});
+    }
+    return result;
+}
+
+void MetricsRegistry::sampleProcess()
+{
+    const qint64 now = steadyNowMs();
+    qint64 last = m_lastProcessSampleMs.load(std::memory_order_relaxed);
+    if (now - last < kProcessSampleIntervalMs
+        || !m_lastProcessSampleMs.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+        return;
+    }
+
+    static MetricGauge& resident = gauge(MetricNames::ResidentBytes);
+    resident.set(static_cast<double>(residentBytes()));
+}
+
+qint64 MetricsRegistry::residentBytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<qint64>(counters.WorkingSetSize);
+    }
+    return 0;
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count)
+        == KERN_SUCCESS) {
+        return static_cast<qint64>(info.resident_size);
+    }
+    return 0;
+#else
+    // Second field of statm: resident pages
+    long pages = 0;
+    FILE* file = std::fopen("/proc/self/statm", "r");
+    if (!file) {
+        return 0;
+    }
+    if (std::fscanf(file, "%*s %ld", &pages) != 1) {
+        pages = 0;
+    }
+    std::fclose(file);
+    return static_cast<qint64>(pages) * sysconf(_SC_PAGESIZE);
+#endif
+}
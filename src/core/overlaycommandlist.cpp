@@ -0,0 +1,109 @@
+#include "core/overlaycommandlist.h"
+#include <algorithm>
+
+OverlayCommandList::OverlayCommandList()
+    : m_canvasSize(1, 1)
+{
+}
+
+void OverlayCommandList::setCanvasSize(const cv::Size& size)
+{
+    // Guard against division by zero on empty frames
+    m_canvasSize = cv::Size(std::max(1, size.width), std::max(1, size.height));
+}
+
+cv::Size OverlayCommandList::canvasSize() const
+{
+    return m_canvasSize;
+}
+
+void OverlayCommandList::addLine(const cv::Point2f& from, const cv::Point2f& to, const QColor& color,
+                                 float thickness, OverlayCommand::Space space)
+{
+    OverlayCommand command;
+    command.type = OverlayCommand::Type::Line;
+    command.space = space;
+    command.p1 = normalize(from, space);
+    command.p2 = normalize(to, space);
+    command.color = color;
+    command.thickness = thickness;
+    m_commands.push_back(std::move(command));
+}
+
+void OverlayCommandList::addCircle(const cv::Point2f& center, float radius, const QColor& color,
+                                   float thickness, bool filled, OverlayCommand::Space space)
+{
+    OverlayCommand command;
+    command.type = OverlayCommand::Type::Circle;
+    command.space = space;
+    command.p1 = normalize(center, space);
+    command.radius = (space == OverlayCommand::Space::Frame)
+                         ? radius / m_canvasSize.width
+                         : radius;
+    command.color = color;
+    command.thickness = thickness;
+    command.filled = filled;
+    m_commands.push_back(std::move(command));
+}
+
+void OverlayCommandList::addRect(const cv::Rect2f& rect, const QColor& color,
+                                 float thickness, bool filled, OverlayCommand::Space space)
+{
+    OverlayCommand command;
+    command.type = OverlayCommand::Type::Rect;
+    command.space = space;
+    command.p1 = normalize(rect.tl(), space);
+    command.p2 = normalize(rect.br(), space);
+    command.color = color;
+    command.thickness = thickness;
+    command.filled = filled;
+    m_commands.push_back(std::move(command));
+}
+
+void OverlayCommandList::addText(const QString& text, const cv::Point2f& position, const QColor& color,
+                                 float fontSize, const QColor& background,
+                                 Qt::Alignment anchor, OverlayCommand::Space space)
+{
+    OverlayCommand command;
+    command.type = OverlayCommand::Type::Text;
+    command.space = space;
+    command.p1 = normalize(position, space);
+    command.color = color;
+    command.background = background;
+    command.text = text;
+    command.fontSize = (space == OverlayCommand::Space::Frame)
+                           ? fontSize / m_canvasSize.height
+                           : fontSize;
+    command.anchor = anchor;
+    m_commands.push_back(std::move(command));
+}
+
+void OverlayCommandList::clear()
+{
+    // Keeps capacity so steady-state frames don't allocate
+    m_commands.clear();
+}
+
+bool OverlayCommandList::isEmpty() const
+{
+    return m_commands.empty();
+}
+
+void OverlayCommandList::swap(OverlayCommandList& other)
+{
+    m_commands.swap(other.m_commands);
+    std::swap(m_canvasSize, other.m_canvasSize);
+}
+
+const std::vector<OverlayCommand>& OverlayCommandList::commands() const
+{
+    return m_commands;
+}
+
+cv::Point2f OverlayCommandList::normalize(const cv::Point2f& point, OverlayCommand::Space space) const
+{
+    if (space == OverlayCommand::Space::Screen) {
+        return point;
+    }
+    return cv::Point2f(point.x / m_canvasSize.width, point.y / m_canvasSize.height);
+}
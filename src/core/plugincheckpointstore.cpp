@@ -0,0 +1,159 @@
+#include "core/plugincheckpointstore.h"
+#include <QMutexLocker>
+#include <algorithm>
+
+namespace {
+
+// Rough heap footprint of a plugin state; exact for the large cases
+// (strings, byte arrays), a flat cost for scalars
+qint64 approximateVariantBytes(const QVariant& value)
+{
+    qint64 bytes = sizeof(QVariant);
+    switch (value.userType()) {
+    case QMetaType::QString:
+        bytes += value.toString().size() * static_cast<qint64>(sizeof(QChar));
+        break;
+    case QMetaType::QByteArray:
+        bytes += value.toByteArray().size();
+        break;
+    case QMetaType::QVariantList:
+        for (const QVariant& item : value.toList()) {
+            bytes += approximateVariantBytes(item);
+        }
+        break;
+    case QMetaType::QVariantMap: {
+        const QVariantMap map = value.toMap();
+        for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+            bytes += it.key().size() * static_cast<qint64>(sizeof(QChar)) + approximateVariantBytes(it.value());
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return bytes;
+}
+
+} // namespace
+
+PluginCheckpointStore::PluginCheckpointStore(int capacity)
+    : m_capacity(std::max(1, capacity))
+    , m_bytes(0)
+    , m_charge(MemorySubsystem::Caches)
+{
+}
+
+void PluginCheckpointStore::insert(std::shared_ptr<const PluginCheckpoint> checkpoint)
+{
+    if (!checkpoint) {
+        return;
+    }
+
+    const qint64 bytes = approximateBytes(*checkpoint);
+
+    QMutexLocker locker(&m_mutex);
+    qint64 timestamp = checkpoint->timestamp;
+    auto existing = m_checkpoints.find(timestamp);
+    if (existing != m_checkpoints.end()) {
+        m_bytes -= approximateBytes(*existing->second);
+    }
+    auto result = m_checkpoints.insert_or_assign(timestamp, std::move(checkpoint));
+    m_bytes += bytes;
+    if (result.second) {
+        m_insertionOrder.push_back(timestamp);
+        evictLocked();
+    }
+    m_charge.set(m_bytes);
+}
+
+std::shared_ptr<const PluginCheckpoint> PluginCheckpointStore::nearest(qint64 timestamp,
+                                                                       qint64 maxDistanceMs) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    // First checkpoint after the target, step back to the one at or before it
+    auto it = m_checkpoints.upper_bound(timestamp);
+    if (it == m_checkpoints.begin()) {
+        return nullptr;
+    }
+    --it;
+
+    if (timestamp - it->first > maxDistanceMs) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+bool PluginCheckpointStore::contains(qint64 timestamp) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_checkpoints.count(timestamp) > 0;
+}
+
+void PluginCheckpointStore::setCapacity(int capacity)
+{
+    QMutexLocker locker(&m_mutex);
+    m_capacity = std::max(1, capacity);
+    evictLocked();
+    m_charge.set(m_bytes);
+}
+
+int PluginCheckpointStore::capacity() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_capacity;
+}
+
+int PluginCheckpointStore::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_checkpoints.size());
+}
+
+void PluginCheckpointStore::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_checkpoints.clear();
+    m_insertionOrder.clear();
+    m_bytes = 0;
+    m_charge.set(0);
+}
+
+void PluginCheckpointStore::trim()
+{
+    QMutexLocker locker(&m_mutex);
+    evictLocked();
+    m_charge.set(m_bytes);
+}
+
+qint64 PluginCheckpointStore::approximateBytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_bytes;
+}
+
+void PluginCheckpointStore::evictLocked()
+{
+    int capacity = m_capacity;
+    if (MemoryAccountant::instance().shouldEvict()) {
+        capacity = std::max(1, m_capacity / 4);
+    }
+
+    while (static_cast<int>(m_checkpoints.size()) > capacity && !m_insertionOrder.empty()) {
+        auto it = m_checkpoints.find(m_insertionOrder.front());
+        if (it != m_checkpoints.end()) {
+            m_bytes -= approximateBytes(*it->second);
+            m_checkpoints.erase(it);
+        }
+        m_insertionOrder.pop_front();
+    }
+}
+
+qint64 PluginCheckpointStore::approximateBytes(const PluginCheckpoint& checkpoint)
+{
+    qint64 bytes = sizeof(PluginCheckpoint);
+    for (const auto& state : checkpoint.states) {
+        bytes += state.first.size() * static_cast<qint64>(sizeof(QChar)) + approximateVariantBytes(state.second);
+    }
+    return bytes;
+}
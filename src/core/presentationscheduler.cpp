@@ -0,0 +1,90 @@
+#include "core/presentationscheduler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Bounds for the vsync estimate (240 Hz to 20 Hz)
+const double kMinVsyncIntervalMs = 1000.0 / 240.0;
+const double kMaxVsyncIntervalMs = 1000.0 / 20.0;
+
+} // namespace
+
+PresentationScheduler::PresentationScheduler()
+    : m_lastVsyncNs(0)
+    , m_vsyncIntervalMs(1000.0 / 60.0)
+    , m_intervalCount(0)
+    , m_intervalMean(0.0)
+    , m_intervalM2(0.0)
+    , m_ptsErrorSum(0.0)
+{
+    m_timer.start();
+}
+
+void PresentationScheduler::reset(double refreshRateHz)
+{
+    if (refreshRateHz > 0.0) {
+        m_vsyncIntervalMs = qBound(kMinVsyncIntervalMs, 1000.0 / refreshRateHz, kMaxVsyncIntervalMs);
+    }
+
+    // Forget the previous session so a pause isn't counted as one long swap
+    m_lastVsyncNs = 0;
+    m_stats = PresentationStats();
+    m_intervalCount = 0;
+    m_intervalMean = 0.0;
+    m_intervalM2 = 0.0;
+    m_ptsErrorSum = 0.0;
+}
+
+void PresentationScheduler::onVsync()
+{
+    qint64 now = m_timer.nsecsElapsed();
+    ++m_stats.vsyncCount;
+
+    if (m_lastVsyncNs > 0) {
+        double interval = (now - m_lastVsyncNs) / 1e6;
+
+        ++m_intervalCount;
+        double delta = interval - m_intervalMean;
+        m_intervalMean += delta / m_intervalCount;
+        m_intervalM2 += delta * (interval - m_intervalMean);
+
+        m_stats.meanSwapIntervalMs = m_intervalMean;
+        m_stats.swapJitterMs = m_intervalCount > 1 ? std::sqrt(m_intervalM2 / (m_intervalCount - 1)) : 0.0;
+        m_stats.maxSwapIntervalMs = std::max(m_stats.maxSwapIntervalMs, interval);
+
+        // Slow EMA, so one late swap doesn't shift the phase estimate
+        if (interval >= kMinVsyncIntervalMs && interval <= kMaxVsyncIntervalMs) {
+            m_vsyncIntervalMs = m_vsyncIntervalMs * 0.95 + interval * 0.05;
+        }
+    }
+
+    m_lastVsyncNs = now;
+}
+
+double PresentationScheduler::displayTimeMs(double clockMs, double rate) const
+{
+    // A frame submitted now is shown at the next swap
+    return clockMs + m_vsyncIntervalMs * rate;
+}
+
+void PresentationScheduler::recordPresented(double ptsMs, double displayTimeMs, qint64 skippedFrames)
+{
+    ++m_stats.presentedFrames;
+    m_stats.skippedFrames += skippedFrames;
+
+    double error = std::abs(ptsMs - displayTimeMs);
+    m_ptsErrorSum += error;
+    m_stats.meanAbsPtsErrorMs = m_ptsErrorSum / m_stats.presentedFrames;
+    m_stats.maxAbsPtsErrorMs = std::max(m_stats.maxAbsPtsErrorMs, error);
+}
+
+void PresentationScheduler::recordRepeated()
+{
+    ++m_stats.repeatedVsyncs;
+}
+
+PresentationStats PresentationScheduler::stats() const
+{
+    return m_stats;
+}
@@ -0,0 +1,287 @@
+#include "core/rawframefile.h"
+#include <QDebug>
+#include <opencv2/core.hpp>
+#include <cstring>
+
+namespace {
+
+const char kMagic[8] = {'B', 'S', 'R', 'A', 'W', 'F', 'R', 'M'};
+
+quint64 alignUp(quint64 bytes)
+{
+    const quint64 alignment = RawFrameFileHeader::kAlignment;
+    return (bytes + alignment - 1) / alignment * alignment;
+}
+
+quint64 headerBytes()
+{
+    return alignUp(sizeof(RawFrameFileHeader));
+}
+
+// Frames as they leave the decoder or reach plugins
+bool isSupportedType(int type)
+{
+    return type == CV_8UC1 || type == CV_8UC3 || type == CV_8UC4;
+}
+
+} // namespace
+
+RawFrameWriter::RawFrameWriter()
+{
+    std::memset(&m_header, 0, sizeof(m_header));
+}
+
+RawFrameWriter::~RawFrameWriter()
+{
+    if (isOpen()) {
+        close();
+    }
+}
+
+bool RawFrameWriter::open(const QString& path, double fps, RawFrameFileHeader::ColorOrder colorOrder)
+{
+    if (isOpen()) {
+        close();
+    }
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+        qWarning() << "[RawFrameWriter] Cannot create" << path << ":" << m_file.errorString();
+        return false;
+    }
+
+    std::memset(&m_header, 0, sizeof(m_header));
+    std::memcpy(m_header.magic, kMagic, sizeof(kMagic));
+    m_header.version = RawFrameFileHeader::kVersion;
+    m_header.colorOrder = colorOrder;
+    m_header.dataOffset = headerBytes();
+    m_header.fps = fps;
+    m_index.clear();
+
+    // Placeholder header, rewritten by close()
+    std::vector<char> zeros(static_cast<size_t>(headerBytes()), 0);
+    if (m_file.write(zeros.data(), static_cast<qint64>(zeros.size())) != static_cast<qint64>(zeros.size())) {
+        qWarning() << "[RawFrameWriter] Write failed:" << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+bool RawFrameWriter::append(const cv::Mat& frame, qint64 timestamp, qint64 frameIndex)
+{
+    if (!isOpen() || frame.empty()) {
+        return false;
+    }
+
+    if (m_index.empty()) {
+        if (!isSupportedType(frame.type())) {
+            qWarning() << "[RawFrameWriter] Only 8-bit 1, 3 or 4 channel frames can be captured";
+            return false;
+        }
+
+        // The first frame fixes the format of the file
+        m_header.rows = frame.rows;
+        m_header.cols = frame.cols;
+        m_header.type = frame.type();
+        m_header.step = static_cast<quint64>(frame.cols) * frame.elemSize();
+        m_header.slotBytes = alignUp(m_header.step * static_cast<quint64>(frame.rows));
+        m_padding.assign(static_cast<size_t>(m_header.slotBytes - m_header.step * frame.rows), 0);
+    } else if (frame.rows != m_header.rows || frame.cols != m_header.cols || frame.type() != m_header.type) {
+        qWarning() << "[RawFrameWriter] Frame format changed, frame dropped";
+        return false;
+    }
+
+    if (frame.isContinuous()) {
+        const qint64 bytes = static_cast<qint64>(m_header.step) * frame.rows;
+        if (m_file.write(reinterpret_cast<const char*>(frame.data), bytes) != bytes) {
+            qWarning() << "[RawFrameWriter] Write failed:" << m_file.errorString();
+            return false;
+        }
+    } else {
+        for (int y = 0; y < frame.rows; ++y) {
+            const qint64 bytes = static_cast<qint64>(m_header.step);
+            if (m_file.write(reinterpret_cast<const char*>(frame.ptr(y)), bytes) != bytes) {
+                qWarning() << "[RawFrameWriter] Write failed:" << m_file.errorString();
+                return false;
+            }
+        }
+    }
+
+    if (!m_padding.empty()
+        && m_file.write(m_padding.data(), static_cast<qint64>(m_padding.size())) != static_cast<qint64>(m_padding.size())) {
+        qWarning() << "[RawFrameWriter] Write failed:" << m_file.errorString();
+        return false;
+    }
+
+    m_index.push_back({timestamp, frameIndex});
+    return true;
+}
+
+bool RawFrameWriter::close()
+{
+    if (!isOpen()) {
+        return false;
+    }
+
+    m_header.frameCount = m_index.size();
+    m_header.indexOffset = m_header.dataOffset + m_header.slotBytes * m_header.frameCount;
+
+    const qint64 indexBytes = static_cast<qint64>(m_index.size() * sizeof(RawFrameIndexEntry));
+    bool success = m_file.seek(static_cast<qint64>(m_header.indexOffset))
+                   && m_file.write(reinterpret_cast<const char*>(m_index.data()), indexBytes) == indexBytes
+                   && m_file.seek(0)
+                   && m_file.write(reinterpret_cast<const char*>(&m_header), sizeof(m_header))
+                          == static_cast<qint64>(sizeof(m_header));
+
+    if (!success) {
+        qWarning() << "[RawFrameWriter] Failed to finish" << m_file.fileName() << ":" << m_file.errorString();
+    } else {
+        qDebug() << "[RawFrameWriter] Wrote" << m_index.size() << "frames to" << m_file.fileName();
+    }
+
+    m_file.close();
+    m_index.clear();
+    return success;
+}
+
+bool RawFrameWriter::isOpen() const
+{
+    return m_file.isOpen();
+}
+
+qint64 RawFrameWriter::frameCount() const
+{
+    return static_cast<qint64>(m_index.size());
+}
+
+QString RawFrameWriter::path() const
+{
+    return m_file.fileName();
+}
+
+RawFrameReader::RawFrameReader()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_header(nullptr)
+    , m_index(nullptr)
+{
+}
+
+RawFrameReader::~RawFrameReader()
+{
+    close();
+}
+
+bool RawFrameReader::open(const QString& path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qWarning() << "[RawFrameReader] Cannot open" << path << ":" << m_file.errorString();
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size < static_cast<qint64>(headerBytes())) {
+        qWarning() << "[RawFrameReader] Not a raw frame file:" << path;
+        close();
+        return false;
+    }
+
+    // Private mapping: consumers may write into frames, the file stays intact
+    m_data = m_file.map(0, m_size, QFileDevice::MapPrivateOption);
+    if (!m_data) {
+        qWarning() << "[RawFrameReader] Cannot map" << path << ":" << m_file.errorString();
+        close();
+        return false;
+    }
+
+    const auto* header = reinterpret_cast<const RawFrameFileHeader*>(m_data);
+    const quint64 size = static_cast<quint64>(m_size);
+    bool valid = std::memcmp(header->magic, kMagic, sizeof(kMagic)) == 0
+                 && header->version == RawFrameFileHeader::kVersion
+                 && header->rows > 0 && header->cols > 0
+                 && isSupportedType(header->type)
+                 && header->step >= static_cast<quint64>(header->cols) * CV_ELEM_SIZE(header->type)
+                 && header->step * static_cast<quint64>(header->rows) <= header->slotBytes
+                 && header->dataOffset % RawFrameFileHeader::kAlignment == 0
+                 && header->slotBytes % RawFrameFileHeader::kAlignment == 0
+                 && header->dataOffset + header->slotBytes * header->frameCount <= header->indexOffset
+                 && header->indexOffset + header->frameCount * sizeof(RawFrameIndexEntry) <= size;
+    if (!valid) {
+        qWarning() << "[RawFrameReader] Invalid or unfinished raw frame file:" << path;
+        close();
+        return false;
+    }
+
+    m_header = header;
+    m_index = reinterpret_cast<const RawFrameIndexEntry*>(m_data + header->indexOffset);
+
+    qDebug() << "[RawFrameReader] Opened" << path << ":" << header->frameCount << "frames of"
+             << header->cols << "x" << header->rows;
+    return true;
+}
+
+void RawFrameReader::close()
+{
+    if (m_data) {
+        m_file.unmap(m_data);
+    }
+    m_file.close();
+    m_data = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_index = nullptr;
+}
+
+bool RawFrameReader::isOpen() const
+{
+    return m_header != nullptr;
+}
+
+qint64 RawFrameReader::frameCount() const
+{
+    return m_header ? static_cast<qint64>(m_header->frameCount) : 0;
+}
+
+cv::Size RawFrameReader::frameSize() const
+{
+    return m_header ? cv::Size(m_header->cols, m_header->rows) : cv::Size();
+}
+
+int RawFrameReader::frameType() const
+{
+    return m_header ? m_header->type : 0;
+}
+
+double RawFrameReader::fps() const
+{
+    return m_header ? m_header->fps : 0.0;
+}
+
+RawFrameFileHeader::ColorOrder RawFrameReader::colorOrder() const
+{
+    return m_header ? static_cast<RawFrameFileHeader::ColorOrder>(m_header->colorOrder)
+                    : RawFrameFileHeader::BGR;
+}
+
+cv::Mat RawFrameReader::frame(qint64 i) const
+{
+    if (!m_header || i < 0 || i >= frameCount()) {
+        return cv::Mat();
+    }
+    uchar* slot = m_data + m_header->dataOffset + m_header->slotBytes * static_cast<quint64>(i);
+    return cv::Mat(m_header->rows, m_header->cols, m_header->type, slot, static_cast<size_t>(m_header->step));
+}
+
+qint64 RawFrameReader::timestamp(qint64 i) const
+{
+    return m_header && i >= 0 && i < frameCount() ? m_index[i].timestamp : 0;
+}
+
+qint64 RawFrameReader::frameIndex(qint64 i) const
+{
+    return m_header && i >= 0 && i < frameCount() ? m_index[i].frameIndex : 0;
+}
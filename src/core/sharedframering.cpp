@@ -0,0 +1,364 @@
+#include "core/sharedframering.h"
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
+namespace {
+
+const size_t kPageSize = 4096;
+
+// Spins before sleeping; a fast plugin answers well within this
+const int kSpinIterations = 2000;
+
+size_t alignToPage(size_t bytes)
+{
+    return (bytes + kPageSize - 1) / kPageSize * kPageSize;
+}
+
+#ifdef __linux__
+// Shared (not FUTEX_PRIVATE) so the two processes wake each other
+void futexWait(std::atomic<uint32_t>* word, uint32_t expected, int timeoutMs)
+{
+    timespec timeout;
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_nsec = (timeoutMs % 1000) * 1000000L;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+void futexWake(std::atomic<uint32_t>* word)
+{
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+#endif
+
+/**
+ * @brief Waits until a sequence counter leaves a value
+ */
+bool waitForChange(std::atomic<uint32_t>& word, uint32_t current, int timeoutMs, intptr_t event)
+{
+    for (int i = 0; i < kSpinIterations; ++i) {
+        if (word.load(std::memory_order_acquire) != current) {
+            return true;
+        }
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (word.load(std::memory_order_acquire) == current) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) {
+            return false;
+        }
+#if defined(__linux__)
+        (void)event;
+        futexWait(&word, current, static_cast<int>(remaining));
+#elif defined(_WIN32)
+        WaitForSingleObject(reinterpret_cast<HANDLE>(event), static_cast<DWORD>(remaining));
+#else
+        (void)event;
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+#endif
+    }
+    return true;
+}
+
+void wake(std::atomic<uint32_t>& word, intptr_t event)
+{
+#if defined(__linux__)
+    (void)event;
+    futexWake(&word);
+#elif defined(_WIN32)
+    (void)word;
+    SetEvent(reinterpret_cast<HANDLE>(event));
+#else
+    (void)word;
+    (void)event;
+#endif
+}
+
+} // namespace
+
+SharedFrameRing::SharedFrameRing()
+    : m_owner(false)
+    , m_base(nullptr)
+    , m_totalBytes(0)
+    , m_handle(-1)
+    , m_requestEvent(0)
+    , m_responseEvent(0)
+{
+}
+
+SharedFrameRing::~SharedFrameRing()
+{
+    close();
+}
+
+bool SharedFrameRing::create(const std::string& name, size_t slotBytes, uint32_t slotCount)
+{
+    close();
+
+    m_name = name;
+    m_owner = true;
+    slotBytes = alignToPage(slotBytes);
+
+    if (!map(headerBytes() + slotBytes * slotCount, true) || !openEvents(true)) {
+        close();
+        return false;
+    }
+
+    // Fresh mapping is zero filled; construct the control block in place
+    SharedFrameHeader* control = new (m_base) SharedFrameHeader();
+    control->magic = SharedFrameHeader::kMagic;
+    control->version = SharedFrameHeader::kVersion;
+    control->slotCount = slotCount;
+    control->slotBytes = slotBytes;
+    control->requestSeq.store(0, std::memory_order_relaxed);
+    control->responseSeq.store(0, std::memory_order_release);
+    return true;
+}
+
+bool SharedFrameRing::attach(const std::string& name)
+{
+    close();
+
+    m_name = name;
+    m_owner = false;
+
+    // The size is taken from the existing object
+    if (!map(0, false) || !openEvents(false)) {
+        close();
+        return false;
+    }
+
+    const SharedFrameHeader* control = header();
+    if (control->magic != SharedFrameHeader::kMagic || control->version != SharedFrameHeader::kVersion
+        || headerBytes() + control->slotBytes * control->slotCount > m_totalBytes) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SharedFrameRing::close()
+{
+    closeEvents();
+
+#ifdef _WIN32
+    if (m_base) {
+        UnmapViewOfFile(m_base);
+    }
+    if (m_handle != -1) {
+        CloseHandle(reinterpret_cast<HANDLE>(m_handle));
+    }
+#else
+    if (m_base) {
+        munmap(m_base, m_totalBytes);
+    }
+    if (m_handle != -1) {
+        ::close(static_cast<int>(m_handle));
+        if (m_owner) {
+            shm_unlink(m_name.c_str());
+        }
+    }
+#endif
+
+    m_base = nullptr;
+    m_totalBytes = 0;
+    m_handle = -1;
+}
+
+bool SharedFrameRing::isOpen() const
+{
+    return m_base != nullptr;
+}
+
+const std::string& SharedFrameRing::name() const
+{
+    return m_name;
+}
+
+SharedFrameHeader* SharedFrameRing::header() const
+{
+    return static_cast<SharedFrameHeader*>(m_base);
+}
+
+uint8_t* SharedFrameRing::slot(uint32_t index) const
+{
+    return static_cast<uint8_t*>(m_base) + headerBytes() + index * header()->slotBytes;
+}
+
+size_t SharedFrameRing::slotBytes() const
+{
+    return m_base ? static_cast<size_t>(header()->slotBytes) : 0;
+}
+
+uint32_t SharedFrameRing::slotCount() const
+{
+    return m_base ? header()->slotCount : 0;
+}
+
+uint32_t SharedFrameRing::postRequest()
+{
+    uint32_t sequence = header()->requestSeq.fetch_add(1, std::memory_order_acq_rel) + 1;
+    wake(header()->requestSeq, m_requestEvent);
+    return sequence;
+}
+
+bool SharedFrameRing::waitRequest(uint32_t lastSeen, int timeoutMs)
+{
+    return waitForChange(header()->requestSeq, lastSeen, timeoutMs, m_requestEvent);
+}
+
+void SharedFrameRing::postResponse()
+{
+    header()->responseSeq.store(header()->requestSeq.load(std::memory_order_acquire),
+                                std::memory_order_release);
+    wake(header()->responseSeq, m_responseEvent);
+}
+
+bool SharedFrameRing::waitResponse(uint32_t sequence, int timeoutMs)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    for (;;) {
+        uint32_t answered = header()->responseSeq.load(std::memory_order_acquire);
+        if (answered == sequence) {
+            return true;
+        }
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0 || !waitForChange(header()->responseSeq, answered,
+                                             static_cast<int>(remaining), m_responseEvent)) {
+            return header()->responseSeq.load(std::memory_order_acquire) == sequence;
+        }
+    }
+}
+
+std::string SharedFrameRing::uniqueName()
+{
+    static std::atomic<int> counter(0);
+#ifdef _WIN32
+    unsigned long pid = GetCurrentProcessId();
+#else
+    unsigned long pid = static_cast<unsigned long>(getpid());
+#endif
+    return "/blazestudio-ring-" + std::to_string(pid) + "-" + std::to_string(counter.fetch_add(1));
+}
+
+bool SharedFrameRing::map(size_t totalBytes, bool create)
+{
+#ifdef _WIN32
+    std::wstring name(m_name.begin(), m_name.end());
+    name = L"Local\\" + name.substr(1);
+
+    HANDLE mapping;
+    if (create) {
+        mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                     static_cast<DWORD>(static_cast<uint64_t>(totalBytes) >> 32),
+                                     static_cast<DWORD>(totalBytes & 0xffffffffu), name.c_str());
+    } else {
+        mapping = OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+    }
+    if (!mapping) {
+        return false;
+    }
+    m_handle = reinterpret_cast<intptr_t>(mapping);
+
+    m_base = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, totalBytes);
+    if (!m_base) {
+        return false;
+    }
+
+    MEMORY_BASIC_INFORMATION info;
+    VirtualQuery(m_base, &info, sizeof(info));
+    m_totalBytes = create ? totalBytes : info.RegionSize;
+    return true;
+#else
+    int fd = create ? shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600)
+                    : shm_open(m_name.c_str(), O_RDWR, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    m_handle = fd;
+
+    if (create) {
+        if (ftruncate(fd, static_cast<off_t>(totalBytes)) != 0) {
+            return false;
+        }
+    } else {
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < headerBytes()) {
+            return false;
+        }
+        totalBytes = static_cast<size_t>(info.st_size);
+    }
+
+    void* base = mmap(nullptr, totalBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    m_base = base;
+    m_totalBytes = totalBytes;
+    return true;
+#endif
+}
+
+bool SharedFrameRing::openEvents(bool create)
+{
+#ifdef _WIN32
+    std::wstring base(m_name.begin(), m_name.end());
+    base = L"Local\\" + base.substr(1);
+    std::wstring requestName = base + L"-request";
+    std::wstring responseName = base + L"-response";
+
+    HANDLE request = create ? CreateEventW(nullptr, FALSE, FALSE, requestName.c_str())
+                            : OpenEventW(EVENT_ALL_ACCESS, FALSE, requestName.c_str());
+    HANDLE response = create ? CreateEventW(nullptr, FALSE, FALSE, responseName.c_str())
+                             : OpenEventW(EVENT_ALL_ACCESS, FALSE, responseName.c_str());
+    m_requestEvent = reinterpret_cast<intptr_t>(request);
+    m_responseEvent = reinterpret_cast<intptr_t>(response);
+    return request && response;
+#else
+    // Futexes live in the mapping itself
+    (void)create;
+    return true;
+#endif
+}
+
+void SharedFrameRing::closeEvents()
+{
+#ifdef _WIN32
+    if (m_requestEvent) {
+        CloseHandle(reinterpret_cast<HANDLE>(m_requestEvent));
+    }
+    if (m_responseEvent) {
+        CloseHandle(reinterpret_cast<HANDLE>(m_responseEvent));
+    }
+#endif
+    m_requestEvent = 0;
+    m_responseEvent = 0;
+}
+
+size_t SharedFrameRing::headerBytes()
+{
+    return alignToPage(sizeof(SharedFrameHeader));
+}
@@ -0,0 +1,265 @@
+#include "core/timestampindex.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <opencv2/videoio.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Frames recorded between two publications to readers
+const size_t kChunkFrames = 512;
+
+const double kFallbackFps = 30.0;
+
+// Each job decodes a whole file; more at once would compete with playback
+const int kMaxIndexJobs = 1;
+
+QThreadPool& indexPool()
+{
+    static QThreadPool pool;
+    static const bool configured = [] {
+        pool.setMaxThreadCount(kMaxIndexJobs);
+        return true;
+    }();
+    Q_UNUSED(configured);
+    return pool;
+}
+
+} // namespace
+
+TimestampIndex::TimestampIndex()
+    : m_nominalFps(kFallbackFps)
+    , m_nominalFrameCount(0)
+    , m_charge(MemorySubsystem::DecoderBuffers)
+    , m_cancel(false)
+    , m_complete(false)
+{
+}
+
+TimestampIndex::~TimestampIndex()
+{
+    cancel();
+}
+
+void TimestampIndex::build(const QString& videoPath, double nominalFps, qint64 nominalFrameCount)
+{
+    cancel();
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_pts.clear();
+        m_pts.shrink_to_fit();
+        m_pts.reserve(static_cast<size_t>(std::max<qint64>(0, nominalFrameCount)));
+        m_nominalFps = nominalFps > 0.0 ? nominalFps : kFallbackFps;
+        m_nominalFrameCount = std::max<qint64>(0, nominalFrameCount);
+        m_charge.set(static_cast<qint64>(m_pts.capacity() * sizeof(qint32)));
+    }
+
+    m_cancel = false;
+    m_complete = false;
+    m_job.reset(QRunnable::create([this, videoPath]() {
+        QThread::currentThread()->setPriority(QThread::LowestPriority);
+        run(videoPath);
+        m_jobDone.release();
+    }));
+    m_job->setAutoDelete(false);
+    indexPool().start(m_job.get());
+}
+
+void TimestampIndex::cancel()
+{
+    if (!m_job) {
+        return;
+    }
+    m_cancel = true;
+
+    // A job still waiting behind other files never starts
+    if (!indexPool().tryTake(m_job.get())) {
+        m_jobDone.acquire();
+    }
+    m_job.reset();
+}
+
+bool TimestampIndex::isComplete() const
+{
+    return m_complete.load();
+}
+
+qint64 TimestampIndex::indexedFrames() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<qint64>(m_pts.size());
+}
+
+qint64 TimestampIndex::frameCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return lastFrameLocked() + 1;
+}
+
+qint64 TimestampIndex::ptsMs(qint64 frameIndex) const
+{
+    QMutexLocker locker(&m_mutex);
+    return extrapolatedPtsLocked(std::max<qint64>(0, frameIndex));
+}
+
+qint64 TimestampIndex::frameAt(qint64 timeMs) const
+{
+    QMutexLocker locker(&m_mutex);
+    return clampFrameLocked(frameAtLocked(static_cast<double>(timeMs)));
+}
+
+qint64 TimestampIndex::nearestFrame(double timeMs) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    const qint64 before = clampFrameLocked(frameAtLocked(timeMs));
+    const qint64 last = lastFrameLocked();
+    if (last >= 0 && before >= last) {
+        return before;
+    }
+
+    const double toBefore = timeMs - extrapolatedPtsLocked(before);
+    const double toAfter = extrapolatedPtsLocked(before + 1) - timeMs;
+    return toAfter < toBefore ? before + 1 : before;
+}
+
+qint64 TimestampIndex::durationMs() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    const size_t count = m_pts.size();
+    if (!m_complete || count == 0) {
+        return extrapolatedPtsLocked(lastFrameLocked() + 1);
+    }
+
+    // The last frame lasts as long as the one before it
+    const qint64 lastDuration = count > 1 ? m_pts[count - 1] - m_pts[count - 2]
+                                          : std::llround(frameIntervalMs());
+    return m_pts[count - 1] + lastDuration;
+}
+
+void TimestampIndex::run(const QString& videoPath)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    cv::VideoCapture capture(videoPath.toStdString());
+    if (!capture.isOpened()) {
+        qWarning() << "[TimestampIndex] Cannot open" << videoPath << "- using the nominal frame rate";
+        return;
+    }
+
+    const double interval = frameIntervalMs();
+    const qint64 repairStep = std::max<qint64>(1, std::llround(interval));
+
+    std::vector<qint32> chunk;
+    chunk.reserve(kChunkFrames);
+    double firstMs = -1.0;
+    qint64 previous = -1;
+    qint64 repaired = 0;
+
+    // grab() decodes without the color conversion; only the timestamp is needed
+    while (!m_cancel.load(std::memory_order_relaxed) && capture.grab()) {
+        const double positionMs = capture.get(cv::CAP_PROP_POS_MSEC);
+        if (firstMs < 0.0) {
+            firstMs = positionMs;
+        }
+
+        qint64 pts = std::llround(positionMs - firstMs);
+
+        // Backends without timestamps report 0 or repeat values: step at the nominal rate
+        if (previous >= 0 && pts <= previous) {
+            pts = previous + repairStep;
+            ++repaired;
+        }
+        previous = pts;
+
+        chunk.push_back(static_cast<qint32>(std::min<qint64>(pts, std::numeric_limits<qint32>::max())));
+        if (chunk.size() >= kChunkFrames) {
+            append(chunk);
+            chunk.clear();
+        }
+    }
+    append(chunk);
+
+    if (m_cancel.load()) {
+        return;
+    }
+    m_complete = true;
+
+    qDebug() << "[TimestampIndex] Indexed" << indexedFrames() << "frames in" << timer.elapsed() << "ms,"
+             << "duration" << durationMs() << "ms," << repaired << "timestamps repaired";
+}
+
+void TimestampIndex::append(const std::vector<qint32>& chunk)
+{
+    if (chunk.empty()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_pts.insert(m_pts.end(), chunk.begin(), chunk.end());
+    m_charge.set(static_cast<qint64>(m_pts.capacity() * sizeof(qint32)));
+}
+
+double TimestampIndex::frameIntervalMs() const
+{
+    return 1000.0 / m_nominalFps;
+}
+
+qint64 TimestampIndex::extrapolatedPtsLocked(qint64 frameIndex) const
+{
+    const qint64 count = static_cast<qint64>(m_pts.size());
+    if (frameIndex < count) {
+        return m_pts[static_cast<size_t>(frameIndex)];
+    }
+    if (count == 0) {
+        return std::llround(frameIndex * frameIntervalMs());
+    }
+    return m_pts[static_cast<size_t>(count - 1)] + std::llround((frameIndex - (count - 1)) * frameIntervalMs());
+}
+
+qint64 TimestampIndex::frameAtLocked(double timeMs) const
+{
+    if (timeMs <= 0.0) {
+        return 0;
+    }
+
+    const qint64 count = static_cast<qint64>(m_pts.size());
+    if (count == 0) {
+        return static_cast<qint64>(std::floor(timeMs / frameIntervalMs()));
+    }
+
+    const double lastPts = m_pts[static_cast<size_t>(count - 1)];
+    if (timeMs >= lastPts) {
+        return (count - 1) + static_cast<qint64>(std::floor((timeMs - lastPts) / frameIntervalMs()));
+    }
+
+    // First PTS after the time, the frame before it is on screen
+    auto after = std::upper_bound(m_pts.begin(), m_pts.end(), timeMs,
+                                  [](double time, qint32 pts) { return time < pts; });
+    return static_cast<qint64>(after - m_pts.begin()) - 1;
+}
+
+qint64 TimestampIndex::clampFrameLocked(qint64 frameIndex) const
+{
+    // Without a frame count (nothing indexed, container doesn't say) there is no upper bound
+    const qint64 last = lastFrameLocked();
+    return last >= 0 ? std::min(frameIndex, last) : frameIndex;
+}
+
+qint64 TimestampIndex::lastFrameLocked() const
+{
+    const qint64 count = static_cast<qint64>(m_pts.size());
+    if (m_complete.load() && count > 0) {
+        return count - 1;
+    }
+    return std::max(count, m_nominalFrameCount) - 1;
+}
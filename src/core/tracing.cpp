@@ -0,0 +1,289 @@
+#include "core/tracing.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+std::atomic<bool> Tracer::s_enabled(false);
+
+namespace {
+
+// 64k events (2 MB) per thread: several minutes of a 60 fps pipeline
+const size_t kEventsPerThread = 1 << 16;
+
+struct TraceEvent
+{
+    qint64 timestampNs;
+    qint64 frameIndex;
+    const char* name;
+    char phase;
+};
+
+/**
+ * @brief Events of one thread; written by that thread only
+ *
+ * count is published with release after the event is stored, so a reader
+ * that loads it with acquire sees complete events below it.
+ */
+struct ThreadBuffer
+{
+    std::unique_ptr<TraceEvent[]> events;
+    std::atomic<size_t> count{0};
+    std::atomic<qint64> dropped{0};
+    std::atomic<quint64> generation{0};
+    int threadId = 0;
+    QString threadName; // Guarded by the registry mutex
+};
+
+struct Registry
+{
+    QMutex mutex;
+    // Buffers outlive their threads so finished threads still show up, until
+    // their events have been exported or a new trace starts
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::set<std::string> interned;
+    std::atomic<quint64> generation{1};
+    std::atomic<qint64> originNs{0};
+    int nextThreadId = 1;
+};
+
+Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+thread_local std::shared_ptr<ThreadBuffer> t_buffer;
+thread_local QString t_threadName; // From setThreadName(), applied when the buffer is created
+
+qint64 nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ThreadBuffer* currentBuffer()
+{
+    if (!t_buffer) {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        buffer->events.reset(new TraceEvent[kEventsPerThread]);
+
+        Registry& reg = registry();
+        QMutexLocker locker(&reg.mutex);
+        buffer->threadId = reg.nextThreadId++;
+        QThread* thread = QThread::currentThread();
+        if (!t_threadName.isEmpty()) {
+            buffer->threadName = t_threadName;
+        } else if (thread && !thread->objectName().isEmpty()) {
+            buffer->threadName = thread->objectName();
+        } else if (QCoreApplication::instance() && thread == QCoreApplication::instance()->thread()) {
+            buffer->threadName = QStringLiteral("GUI");
+        } else {
+            buffer->threadName = QString("Thread %1").arg(buffer->threadId);
+        }
+        buffer->generation.store(reg.generation.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        reg.buffers.push_back(buffer);
+        t_buffer = std::move(buffer);
+    }
+    return t_buffer.get();
+}
+
+/**
+ * @brief Frees the buffers of exited threads that hold nothing left to export
+ * @param exported Whether the current trace has just been written out
+ */
+void releaseExitedLocked(Registry& reg, bool exported)
+{
+    const quint64 generation = reg.generation.load(std::memory_order_relaxed);
+    auto& buffers = reg.buffers;
+    buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                                 [generation, exported](const std::shared_ptr<ThreadBuffer>& buffer) {
+                                     // The registry holds the last reference once the thread is gone
+                                     const bool exited = buffer.use_count() == 1;
+                                     const bool stale = buffer->generation.load(std::memory_order_relaxed)
+                                                        != generation;
+                                     return exited && (stale || exported);
+                                 }),
+                  buffers.end());
+}
+
+void appendEscaped(QByteArray& out, const char* text)
+{
+    for (const char* c = text; *c; ++c) {
+        switch (*c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        default:
+            if (static_cast<unsigned char>(*c) >= 0x20) {
+                out += *c;
+            }
+            break;
+        }
+    }
+}
+
+} // namespace
+
+void Tracer::start()
+{
+    Registry& reg = registry();
+    {
+        QMutexLocker locker(&reg.mutex);
+        // Buffers notice the new generation on their next event and rewind
+        reg.generation.fetch_add(1, std::memory_order_relaxed);
+        reg.originNs.store(nowNs(), std::memory_order_relaxed);
+        releaseExitedLocked(reg, false);
+    }
+    s_enabled.store(true, std::memory_order_release);
+    qDebug() << "[Tracer] Recording started";
+}
+
+void Tracer::stop()
+{
+    s_enabled.store(false, std::memory_order_release);
+    qDebug() << "[Tracer] Recording stopped," << eventCount() << "events," << droppedEvents() << "dropped";
+}
+
+void Tracer::record(Phase phase, const char* name, qint64 frameIndex)
+{
+    ThreadBuffer* buffer = currentBuffer();
+
+    quint64 generation = registry().generation.load(std::memory_order_relaxed);
+    if (buffer->generation.load(std::memory_order_relaxed) != generation) {
+        buffer->count.store(0, std::memory_order_relaxed);
+        buffer->dropped.store(0, std::memory_order_relaxed);
+        buffer->generation.store(generation, std::memory_order_release);
+    }
+
+    size_t index = buffer->count.load(std::memory_order_relaxed);
+    if (index >= kEventsPerThread) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    TraceEvent& event = buffer->events[index];
+    event.timestampNs = nowNs();
+    event.frameIndex = frameIndex;
+    event.name = name;
+    event.phase = static_cast<char>(phase);
+    buffer->count.store(index + 1, std::memory_order_release);
+}
+
+const char* Tracer::intern(const QString& name)
+{
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    // std::set nodes never move, so c_str() stays valid
+    return reg.interned.insert(name.toStdString()).first->c_str();
+}
+
+void Tracer::setThreadName(const QString& name)
+{
+    // Pool threads name themselves whether or not tracing is on; the 2 MB
+    // buffer is only allocated once the thread actually records
+    t_threadName = name;
+    if (t_buffer) {
+        QMutexLocker locker(&registry().mutex);
+        t_buffer->threadName = name;
+    }
+}
+
+bool Tracer::writeChromeTrace(const QString& path)
+{
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    const quint64 generation = reg.generation.load(std::memory_order_relaxed);
+    const qint64 originNs = reg.originNs.load(std::memory_order_relaxed);
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+
+    QByteArray out;
+    out.reserve(1024 * 1024);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+
+    for (const auto& buffer : reg.buffers) {
+        if (buffer->generation.load(std::memory_order_acquire) != generation) {
+            continue;
+        }
+        const size_t count = buffer->count.load(std::memory_order_acquire);
+        const QByteArray tid = QByteArray::number(buffer->threadId);
+
+        if (!first) {
+            out += ",\n";
+        }
+        first = false;
+        out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid + ",\"tid\":" + tid
+               + ",\"args\":{\"name\":\"";
+        appendEscaped(out, buffer->threadName.toUtf8().constData());
+        out += "\"}}";
+
+        for (size_t i = 0; i < count; ++i) {
+            const TraceEvent& event = buffer->events[i];
+            out += ",\n{\"name\":\"";
+            appendEscaped(out, event.name);
+            out += "\",\"ph\":\"";
+            out += event.phase;
+            out += "\",\"ts\":";
+            out += QByteArray::number((event.timestampNs - originNs) / 1000.0, 'f', 3);
+            out += ",\"pid\":" + pid + ",\"tid\":" + tid;
+            if (event.phase == static_cast<char>(Phase::Instant)) {
+                out += ",\"s\":\"t\"";
+            }
+            if (event.frameIndex >= 0) {
+                out += ",\"args\":{\"frame\":" + QByteArray::number(event.frameIndex) + "}";
+            }
+            out += "}";
+        }
+    }
+    out += "\n]}\n";
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(out) != out.size()) {
+        qWarning() << "[Tracer] Failed to write trace to" << path << ":" << file.errorString();
+        return false;
+    }
+
+    releaseExitedLocked(reg, true);
+    qDebug() << "[Tracer] Trace written to" << path;
+    return true;
+}
+
+qint64 Tracer::eventCount()
+{
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    const quint64 generation = reg.generation.load(std::memory_order_relaxed);
+
+    qint64 total = 0;
+    for (const auto& buffer : reg.buffers) {
+        if (buffer->generation.load(std::memory_order_acquire) == generation) {
+            total += static_cast<qint64>(buffer->count.load(std::memory_order_acquire));
+        }
+    }
+    return total;
+}
+
+qint64 Tracer::droppedEvents()
+{
+    Registry& reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    const quint64 generation = reg.generation.load(std::memory_order_relaxed);
+
+    qint64 total = 0;
+    for (const auto& buffer : reg.buffers) {
+        if (buffer->generation.load(std::memory_order_acquire) == generation) {
+            total += buffer->dropped.load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
@@ -1,10 +1,61 @@
 #include "core/videopluginmanager.h"
+#include "plugins/ivideopluginfactory.h"
+#include "plugins/remotevideoplugin.h"
+#include "core/logger.h"
+#include "core/memoryaccountant.h"
+#include "core/tracing.h"
 #include <QDebug>
+#include <QDir>
+#include <QJsonObject>
+#include <QLibrary>
+#include <QMutexLocker>
+#include <QPluginLoader>
 #include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double kDefaultFps = 30.0;
+
+// Restore window when none is set: one checkpoint interval, so any seek into
+// a played stretch finds a checkpoint and replays fewer frames than that
+qint64 defaultRestoreDistanceMs(int intervalFrames, double fps)
+{
+    return std::llround(intervalFrames * 1000.0 / (fps > 0.0 ? fps : kDefaultFps));
+}
+
+/**
+ * @brief Plugin memory goes to the process-wide accountant
+ */
+class AccountingHost : public IPluginHost
+{
+public:
+    void chargeMemory(MemorySubsystem subsystem, qint64 delta) override
+    {
+        MemoryAccountant::instance().add(subsystem, delta);
+    }
+};
+
+IPluginHost* pluginHost()
+{
+    static AccountingHost host;
+    return &host;
+}
+
+} // namespace
 
 VideoPluginManager::VideoPluginManager(QObject *parent)
     : QObject(parent)
-    , m_needsSort(false)
+    , m_checkpointInterval(30)
+    , m_checkpointMaxDistance(-1)
+    , m_restorePending(false)
+    , m_keepOriginal(false)
+    , m_cloneCount(0)
+    , m_processedFrames(0)
+    , m_processedMetric(&MetricsRegistry::instance().counter(MetricNames::FramesProcessed))
+    , m_cloneMetric(&MetricsRegistry::instance().counter(MetricNames::FrameClones))
+    , m_checkpointMetric(&MetricsRegistry::instance().gauge(MetricNames::Checkpoints))
+    , m_proxyEnabled(false)
 {
     qDebug() << "[VideoPluginManager] Initialized";
 }
@@ -13,6 +64,9 @@ VideoPluginManager::~VideoPluginManager()
 {
     finalizePlugins();
     qDebug() << "[VideoPluginManager] Destroyed";
+
+    // Libraries stay mapped: QPluginLoader does not unload on destruction,
+    // and shared plugin objects handed out may still run library code
 }
 
 void VideoPluginManager::addPlugin(std::shared_ptr<IVideoPlugin> plugin)
@@ -32,8 +86,9 @@ void VideoPluginManager::addPlugin(std::shared_ptr<IVideoPlugin> plugin)
         }
     }
 
+    plugin->setHost(pluginHost());
     m_plugins.append(plugin);
-    m_needsSort = true;
+    sortPluginsByPriority();
 
     qDebug() << "[VideoPluginManager] Plugin added:" << pluginName
              << "Version:" << plugin->getVersion()
@@ -65,7 +120,146 @@ void VideoPluginManager::removeAllPlugins()
     qDebug() << "[VideoPluginManager] Removing all plugins";
     finalizePlugins();
     m_plugins.clear();
-    m_enabledPlugins.clear();
+    updateEnabledPluginsCache();
+}
+
+int VideoPluginManager::discoverPlugins(const QString& directory)
+{
+    QDir dir(directory);
+    if (!dir.exists()) {
+        qDebug() << "[VideoPluginManager] Plugin directory not found:" << directory;
+        return 0;
+    }
+
+    int discovered = 0;
+    const QStringList files = dir.entryList(QDir::Files);
+    for (const QString& file : files) {
+        QString path = dir.absoluteFilePath(file);
+        if (!QLibrary::isLibrary(path)) {
+            continue;
+        }
+
+        // metaData() reads the embedded JSON without loading the library
+        auto loader = std::make_unique<QPluginLoader>(path);
+        QJsonObject root = loader->metaData();
+        if (root.value("IID").toString() != QLatin1String(IVideoPluginFactory_iid)) {
+            continue;
+        }
+
+        QVariantMap metadata = root.value("MetaData").toObject().toVariantMap();
+        QString name = metadata.value("name").toString();
+        if (name.isEmpty()) {
+            qWarning() << "[VideoPluginManager] Plugin without name in metadata:" << path;
+            continue;
+        }
+
+        if (getAvailablePlugins().contains(name)) {
+            qWarning() << "[VideoPluginManager] Plugin already known, skipping:" << path;
+            continue;
+        }
+
+        metadata.insert("file", path);
+
+        DiscoveredPlugin entry;
+        entry.name = name;
+        entry.metadata = metadata;
+        entry.loader = std::move(loader);
+        entry.isolated = metadata.value("isolated", false).toBool();
+        m_discovered.push_back(std::move(entry));
+        ++discovered;
+
+        qDebug() << "[VideoPluginManager] Plugin discovered:" << name
+                 << "Version:" << metadata.value("version").toString()
+                 << "File:" << file;
+    }
+
+    return discovered;
+}
+
+bool VideoPluginManager::setPluginIsolated(const QString& pluginName, bool isolated)
+{
+    for (auto& entry : m_discovered) {
+        if (entry.name == pluginName) {
+            if (entry.loaded) {
+                qWarning() << "[VideoPluginManager] Plugin already loaded, isolation unchanged:" << pluginName;
+                return false;
+            }
+            entry.isolated = isolated;
+            return true;
+        }
+    }
+    return false;
+}
+
+QStringList VideoPluginManager::getAvailablePlugins() const
+{
+    QStringList names;
+    for (const auto& plugin : m_plugins) {
+        names.append(plugin->getName());
+    }
+    for (const auto& entry : m_discovered) {
+        if (!names.contains(entry.name)) {
+            names.append(entry.name);
+        }
+    }
+    return names;
+}
+
+QVariantMap VideoPluginManager::getPluginMetadata(const QString& pluginName) const
+{
+    for (const auto& entry : m_discovered) {
+        if (entry.name == pluginName) {
+            QVariantMap metadata = entry.metadata;
+            metadata.insert("loaded", entry.loaded);
+            return metadata;
+        }
+    }
+    return QVariantMap();
+}
+
+std::shared_ptr<IVideoPlugin> VideoPluginManager::loadDiscoveredPlugin(const QString& pluginName)
+{
+    auto it = std::find_if(m_discovered.begin(), m_discovered.end(),
+                           [&](const DiscoveredPlugin& entry) { return entry.name == pluginName; });
+    if (it == m_discovered.end()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<IVideoPlugin> plugin;
+    if (it->isolated) {
+        // The library is only loaded by the host process
+        plugin = std::make_shared<RemoteVideoPlugin>(it->loader->fileName(), it->metadata);
+    } else {
+        QObject* instance = it->loader->instance();
+        auto* factory = qobject_cast<IVideoPluginFactory*>(instance);
+        if (!factory) {
+            qWarning() << "[VideoPluginManager] Failed to load plugin" << pluginName
+                       << ":" << it->loader->errorString();
+            return nullptr;
+        }
+        plugin = factory->createPlugin();
+    }
+
+    if (!plugin || plugin->getName() != pluginName) {
+        qWarning() << "[VideoPluginManager] Plugin library did not create" << pluginName;
+        return nullptr;
+    }
+    it->loaded = true;
+
+    // Catch up with the video that is already open
+    if (!m_videoInfo.isEmpty()) {
+        try {
+            plugin->initialize(m_videoInfo);
+        } catch (const std::exception& e) {
+            qWarning() << "[VideoPluginManager] Error initializing plugin"
+                      << pluginName << ":" << e.what();
+            return nullptr;
+        }
+    }
+
+    qDebug() << "[VideoPluginManager] Plugin loaded on demand:" << pluginName;
+    addPlugin(plugin);
+    return plugin;
 }
 
 std::shared_ptr<IVideoPlugin> VideoPluginManager::getPlugin(const QString& pluginName)
@@ -83,39 +277,220 @@ QList<std::shared_ptr<IVideoPlugin>> VideoPluginManager::getAllPlugins() const
     return m_plugins;
 }
 
-bool VideoPluginManager::processFrame(cv::Mat& frame, qint64 timestamp, qint64 frameIndex)
+bool VideoPluginManager::processFrame(cv::Mat& frame, qint64 timestamp, qint64 frameIndex,
+                                      ProcessingMode mode)
 {
     if (frame.empty()) {
         return false;
     }
 
-    // Ordenar plugins se necessário
-    if (m_needsSort) {
-        sortPluginsByPriority();
-        m_needsSort = false;
+    // Pin this frame's chain; later mutations publish a new one
+    auto chain = m_chain.read();
+    ScopedLatency chainTiming(&m_chainLatency);
+    TRACE_SCOPE("plugins", frameIndex);
+
+    m_overlay.clear();
+    m_context.reset(timestamp, frameIndex);
+    m_processedFrames.fetch_add(1, std::memory_order_relaxed);
+    m_processedMetric->add();
+
+    // State from before a seek goes back in ahead of the first new frame
+    restorePendingCheckpoint(*chain);
+
+    // Shares the buffer; the first writer below then copies it
+    m_original = m_keepOriginal ? frame : cv::Mat();
+
+    bool useProxy = m_proxyEnabled && mode == ProcessingMode::Interactive;
+    if (useProxy) {
+        m_pyramid.reset(frame);
     }
 
-    // Processar apenas plugins habilitados (usando cache)
+    // Frame the chain currently works on (a pyramid level in proxy mode)
+    cv::Mat working = useProxy ? cv::Mat() : frame;
+
+    // Processar apenas plugins habilitados (usando snapshot)
     bool allSuccess = true;
-    for (const auto& plugin : m_enabledPlugins) {
+    for (size_t i = 0; i < chain->plugins.size(); ++i) {
+        const auto& plugin = chain->plugins[i];
         try {
-            if (!plugin->processFrame(frame, timestamp, frameIndex)) {
-                qWarning() << "[VideoPluginManager] Plugin failed processing:"
-                          << plugin->getName();
+            if (useProxy) {
+                cv::Size required = requiredResolution(plugin, frame.size());
+                if (working.empty()) {
+                    // Nothing touched the frame yet, take the level as is
+                    working = m_pyramid.levelFor(required);
+                } else {
+                    // Earlier plugins may have drawn on it, so rescale their result
+                    cv::Size levelSize = m_pyramid.levelSizeFor(required);
+                    if (working.size() != levelSize) {
+                        cv::Mat rescaled;
+                        cv::resize(working, rescaled, levelSize, 0, 0,
+                                   levelSize.width < working.cols ? cv::INTER_AREA : cv::INTER_LINEAR);
+                        working = rescaled;
+                    }
+                }
+            }
+
+            // Outputs only earlier plugins would read are not worth producing
+            m_context.setWantedKeys(chain->wantedAfter[i]);
+
+            // Asked once per frame; the plugin learns the answer through the context
+            const bool writable = plugin->frameAccess() == IVideoPlugin::FrameAccess::ReadWrite;
+            m_context.setFrameWritable(writable);
+
+            bool processed;
+            if (writable) {
+                // Materialize a private copy only if a reader still holds the buffer
+                if (isSharedElsewhere(working, frame, useProxy)) {
+                    working = working.clone();
+                    m_cloneCount.fetch_add(1, std::memory_order_relaxed);
+                    m_cloneMetric->add();
+                }
+                ScopedLatency timing(chain->latency[i].get());
+                TRACE_SCOPE(chain->traceNames[i], frameIndex);
+                processed = plugin->processFrame(working, m_context);
+            } else {
+                // Own header, so a reader can keep the buffer but not rebind ours
+                cv::Mat view = working;
+                ScopedLatency timing(chain->latency[i].get());
+                TRACE_SCOPE(chain->traceNames[i], frameIndex);
+                processed = plugin->processFrame(view, m_context);
+            }
+            if (!processed) {
+                LOG_WARNING("VideoPluginManager", "Plugin failed processing: %1", plugin->getName());
                 allSuccess = false;
             }
+
+            // Overlay coordinates refer to the frame as this plugin left it
+            m_overlay.setCanvasSize(working.size());
+            plugin->emitOverlay(m_overlay, timestamp, frameIndex);
         } catch (const std::exception& e) {
-            qWarning() << "[VideoPluginManager] Exception in plugin" << plugin->getName()
-                      << ":" << e.what();
+            LOG_WARNING("VideoPluginManager", "Exception in plugin %1: %2", plugin->getName(), e.what());
             allSuccess = false;
         }
+
+        // Nobody later in the chain reads these anymore
+        for (const QString& key : chain->releaseAfter[i]) {
+            m_context.remove(key);
+        }
+    }
+
+    // The frame retires here, drop whatever is left
+    m_context.clear();
+
+    int interval = m_checkpointInterval.load(std::memory_order_relaxed);
+    if (interval > 0 && frameIndex % interval == 0) {
+        // Checkpoints only speed up later seeks; skip them when memory is tight
+        if (MemoryAccountant::instance().shouldThrottle()) {
+            m_checkpoints.trim();
+            m_checkpointMetric->set(m_checkpoints.size());
+        } else {
+            captureCheckpoint(*chain, timestamp, frameIndex);
+        }
+    }
+
+    // Plugins may have replaced the buffer, and in proxy mode it is a level
+    if (!working.empty()) {
+        frame = working;
     }
 
     return allSuccess;
 }
 
+void VideoPluginManager::setProxyEnabled(bool enabled)
+{
+    m_proxyEnabled = enabled;
+    qDebug() << "[VideoPluginManager] Proxy processing" << (enabled ? "enabled" : "disabled");
+}
+
+bool VideoPluginManager::isProxyEnabled() const
+{
+    return m_proxyEnabled;
+}
+
+void VideoPluginManager::setKeepOriginal(bool keep)
+{
+    m_keepOriginal = keep;
+    if (!keep) {
+        m_original.release();
+    }
+}
+
+bool VideoPluginManager::isKeepOriginal() const
+{
+    return m_keepOriginal;
+}
+
+void VideoPluginManager::setMetricsScope(const QString& scope)
+{
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    m_processedMetric = &registry.counter(MetricNames::scoped(scope, MetricNames::FramesProcessed));
+    m_cloneMetric = &registry.counter(MetricNames::scoped(scope, MetricNames::FrameClones));
+    m_checkpointMetric = &registry.gauge(MetricNames::scoped(scope, MetricNames::Checkpoints));
+}
+
+cv::Mat VideoPluginManager::originalFrame() const
+{
+    return m_original;
+}
+
+qint64 VideoPluginManager::getCloneCount() const
+{
+    return m_cloneCount.load(std::memory_order_relaxed);
+}
+
+qint64 VideoPluginManager::getProcessedFrameCount() const
+{
+    return m_processedFrames.load(std::memory_order_relaxed);
+}
+
+void VideoPluginManager::setDisplaySize(const cv::Size& size)
+{
+    m_displaySize = size;
+}
+
+QList<PluginLatency> VideoPluginManager::getPluginLatencies() const
+{
+    QList<PluginLatency> result;
+    for (const auto& plugin : m_plugins) {
+        PluginLatency entry;
+        entry.name = plugin->getName();
+        entry.enabled = plugin->isEnabled();
+        entry.status = plugin->getSettings().value("status").toString();
+        auto histogram = m_latency.value(entry.name);
+        if (histogram) {
+            entry.stats = histogram->stats();
+        }
+        result.append(entry);
+    }
+    return result;
+}
+
+LatencyStats VideoPluginManager::getChainLatency() const
+{
+    return m_chainLatency.stats();
+}
+
+void VideoPluginManager::resetLatencyStats()
+{
+    for (const auto& histogram : m_latency) {
+        histogram->reset();
+    }
+    m_chainLatency.reset();
+}
+
+void VideoPluginManager::takeOverlayCommands(OverlayCommandList& target)
+{
+    target.swap(m_overlay);
+    m_overlay.clear();
+}
+
 void VideoPluginManager::initializePlugins(const QVariantMap& videoInfo)
 {
+    m_videoInfo = videoInfo;
+
+    // Checkpoints describe the previous video
+    m_checkpoints.clear();
+
     qDebug() << "[VideoPluginManager] Initializing" << m_plugins.size() << "plugins";
     
     for (const auto& plugin : m_plugins) {
@@ -145,40 +520,157 @@ void VideoPluginManager::finalizePlugins()
         }
     }
 
-    m_enabledPlugins.clear();
+    // Finalized plugins must not see more frames until reinitialized
+    QMutexLocker locker(&m_chainWriteMutex);
+    m_chain.publish(std::make_unique<PluginChain>());
+    m_videoInfo.clear();
 }
 
 void VideoPluginManager::notifyPlaybackStarted()
 {
-    for (const auto& plugin : m_enabledPlugins) {
+    auto chain = m_chain.read();
+    for (const auto& plugin : chain->plugins) {
         plugin->onPlaybackStarted();
     }
 }
 
 void VideoPluginManager::notifyPlaybackPaused()
 {
-    for (const auto& plugin : m_enabledPlugins) {
+    auto chain = m_chain.read();
+    for (const auto& plugin : chain->plugins) {
         plugin->onPlaybackPaused();
     }
 }
 
 void VideoPluginManager::notifyPlaybackStopped()
 {
-    for (const auto& plugin : m_enabledPlugins) {
+    auto chain = m_chain.read();
+    for (const auto& plugin : chain->plugins) {
         plugin->onPlaybackStopped();
     }
 }
 
-void VideoPluginManager::notifySeek(qint64 position)
+qint64 VideoPluginManager::notifySeek(qint64 position)
 {
-    for (const auto& plugin : m_enabledPlugins) {
+    auto chain = m_chain.read();
+    for (const auto& plugin : chain->plugins) {
         plugin->onSeek(position);
     }
+
+    qint64 maxDistance = m_checkpointMaxDistance.load();
+    if (maxDistance < 0) {
+        maxDistance = defaultRestoreDistanceMs(m_checkpointInterval.load(),
+                                               m_videoInfo.value("fps", kDefaultFps).toDouble());
+    }
+
+    // Restored on the processing thread, just before the next frame. The
+    // caller replays the frames between the checkpoint and the target, so
+    // trackers arrive at the target as if playback had run through. A
+    // checkpoint holds the state after its frame, so it must be an earlier one.
+    auto checkpoint = m_checkpoints.nearest(position - 1, maxDistance);
+    QMutexLocker locker(&m_pendingRestoreMutex);
+    m_pendingRestore = checkpoint;
+    m_restorePending.store(checkpoint != nullptr, std::memory_order_release);
+    return checkpoint ? checkpoint->frameIndex : -1;
+}
+
+void VideoPluginManager::setCheckpointInterval(int frames)
+{
+    m_checkpointInterval = std::max(0, frames);
+}
+
+int VideoPluginManager::checkpointInterval() const
+{
+    return m_checkpointInterval;
+}
+
+void VideoPluginManager::setCheckpointCapacity(int checkpoints)
+{
+    m_checkpoints.setCapacity(checkpoints);
+}
+
+void VideoPluginManager::setCheckpointMaxDistance(qint64 milliseconds)
+{
+    m_checkpointMaxDistance = std::max<qint64>(-1, milliseconds);
+}
+
+int VideoPluginManager::getCheckpointCount() const
+{
+    return m_checkpoints.size();
+}
+
+void VideoPluginManager::captureCheckpoint(const PluginChain& chain, qint64 timestamp, qint64 frameIndex)
+{
+    // Replaying a stretch after a seek would capture the same frames again
+    if (m_checkpoints.contains(timestamp)) {
+        return;
+    }
+
+    auto checkpoint = std::make_shared<PluginCheckpoint>();
+    checkpoint->frameIndex = frameIndex;
+    checkpoint->timestamp = timestamp;
+    for (const auto& plugin : chain.plugins) {
+        if (!plugin->supportsStateSnapshot()) {
+            continue;
+        }
+        try {
+            checkpoint->states.emplace_back(plugin->getName(), plugin->snapshotState());
+        } catch (const std::exception& e) {
+            qWarning() << "[VideoPluginManager] Exception snapshotting plugin" << plugin->getName()
+                      << ":" << e.what();
+        }
+    }
+
+    if (!checkpoint->states.empty()) {
+        m_checkpoints.insert(std::move(checkpoint));
+        m_checkpointMetric->set(m_checkpoints.size());
+    }
+}
+
+void VideoPluginManager::restorePendingCheckpoint(const PluginChain& chain)
+{
+    // Every frame passes here; only take the lock after a seek
+    if (!m_restorePending.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::shared_ptr<const PluginCheckpoint> checkpoint;
+    {
+        QMutexLocker locker(&m_pendingRestoreMutex);
+        m_restorePending.store(false, std::memory_order_relaxed);
+        if (!m_pendingRestore) {
+            return;
+        }
+        checkpoint.swap(m_pendingRestore);
+    }
+
+    for (const auto& plugin : chain.plugins) {
+        if (!plugin->supportsStateSnapshot()) {
+            continue;
+        }
+        for (const auto& state : checkpoint->states) {
+            if (state.first != plugin->getName()) {
+                continue;
+            }
+            try {
+                plugin->restoreState(state.second);
+            } catch (const std::exception& e) {
+                qWarning() << "[VideoPluginManager] Exception restoring plugin" << plugin->getName()
+                          << ":" << e.what();
+            }
+            break;
+        }
+    }
+
+    qDebug() << "[VideoPluginManager] Restored plugin state from frame" << checkpoint->frameIndex;
 }
 
 bool VideoPluginManager::setPluginEnabled(const QString& pluginName, bool enabled)
 {
     auto plugin = getPlugin(pluginName);
+    if (!plugin && enabled) {
+        plugin = loadDiscoveredPlugin(pluginName);
+    }
     if (!plugin) {
         return false;
     }
@@ -200,28 +692,174 @@ int VideoPluginManager::getPluginCount() const
 
 int VideoPluginManager::getEnabledPluginCount() const
 {
-    return m_enabledPlugins.size();
+    auto chain = m_chain.read();
+    return static_cast<int>(chain->plugins.size());
+}
+
+std::shared_ptr<LatencyHistogram> VideoPluginManager::latencyFor(const QString& pluginName)
+{
+    // Kept across disable/enable so the history survives toggling
+    auto& histogram = m_latency[pluginName];
+    if (!histogram) {
+        histogram = std::make_shared<LatencyHistogram>();
+    }
+    return histogram;
+}
+
+bool VideoPluginManager::isSharedElsewhere(const cv::Mat& working, const cv::Mat& frame,
+                                           bool useProxy) const
+{
+    if (!working.u) {
+        return false;
+    }
+
+    // References the chain itself accounts for: the working header, the
+    // caller's frame it was taken from, and the pyramid level it came from
+    int owners = 1;
+    if (frame.u == working.u) {
+        ++owners;
+    }
+    if (useProxy && m_pyramid.holds(working)) {
+        ++owners;
+    }
+    return working.u->refcount > owners;
 }
 
 void VideoPluginManager::sortPluginsByPriority()
 {
-    std::sort(m_plugins.begin(), m_plugins.end(),
+    std::stable_sort(m_plugins.begin(), m_plugins.end(),
               [](const std::shared_ptr<IVideoPlugin>& a, const std::shared_ptr<IVideoPlugin>& b) {
                   return a->getPriority() < b->getPriority();
               });
 }
 
+void VideoPluginManager::orderByDependencies(std::vector<std::shared_ptr<IVideoPlugin>>& plugins)
+{
+    const size_t count = plugins.size();
+
+    // producers[i] lists the plugins whose output plugin i consumes
+    std::vector<std::vector<size_t>> producers(count);
+    for (size_t consumer = 0; consumer < count; ++consumer) {
+        const QStringList consumed = plugins[consumer]->consumedKeys();
+        if (consumed.isEmpty()) {
+            continue;
+        }
+        for (size_t producer = 0; producer < count; ++producer) {
+            if (producer == consumer) {
+                continue;
+            }
+            for (const QString& key : plugins[producer]->producedKeys()) {
+                if (consumed.contains(key)) {
+                    producers[consumer].push_back(producer);
+                    break;
+                }
+            }
+        }
+    }
+
+    // Kahn's algorithm; among ready plugins the input (priority) order wins
+    std::vector<std::shared_ptr<IVideoPlugin>> ordered;
+    ordered.reserve(count);
+    std::vector<bool> placed(count, false);
+    while (ordered.size() < count) {
+        size_t next = count;
+        for (size_t i = 0; i < count && next == count; ++i) {
+            if (placed[i]) {
+                continue;
+            }
+            bool ready = std::all_of(producers[i].begin(), producers[i].end(),
+                                     [&](size_t producer) { return placed[producer]; });
+            if (ready) {
+                next = i;
+            }
+        }
+
+        if (next == count) {
+            // Dependency cycle, fall back to priority for the rest
+            next = std::find(placed.begin(), placed.end(), false) - placed.begin();
+            qWarning() << "[VideoPluginManager] Dependency cycle at plugin"
+                       << plugins[next]->getName();
+        }
+
+        placed[next] = true;
+        ordered.push_back(plugins[next]);
+    }
+
+    plugins.swap(ordered);
+}
+
+cv::Size VideoPluginManager::requiredResolution(const std::shared_ptr<IVideoPlugin>& plugin,
+                                               const cv::Size& sourceSize) const
+{
+    cv::Size required = plugin->getMinimumResolution();
+
+    if (plugin->isVisualPlugin() && m_displaySize.area() > 0 && sourceSize.area() > 0) {
+        // Size of the video rectangle once fitted into the display
+        double scale = std::min(static_cast<double>(m_displaySize.width) / sourceSize.width,
+                                static_cast<double>(m_displaySize.height) / sourceSize.height);
+        scale = std::min(scale, 1.0);
+        cv::Size display(static_cast<int>(std::ceil(sourceSize.width * scale)),
+                         static_cast<int>(std::ceil(sourceSize.height * scale)));
+
+        if (required.empty()) {
+            return display;
+        }
+        return cv::Size(std::max(required.width, display.width),
+                        std::max(required.height, display.height));
+    }
+
+    // Empty means full resolution
+    return required;
+}
+
 void VideoPluginManager::updateEnabledPluginsCache()
 {
-    m_enabledPlugins.clear();
-    
+    // Build the next chain off to the side; m_plugins is already sorted
+    auto chain = std::make_unique<PluginChain>();
+    chain->plugins.reserve(m_plugins.size());
     for (const auto& plugin : m_plugins) {
         if (plugin->isEnabled()) {
-            m_enabledPlugins.append(plugin);
+            chain->plugins.push_back(plugin);
+        }
+    }
+    orderByDependencies(chain->plugins);
+
+    chain->latency.reserve(chain->plugins.size());
+    chain->traceNames.reserve(chain->plugins.size());
+    for (const auto& plugin : chain->plugins) {
+        chain->latency.push_back(latencyFor(plugin->getName()));
+        chain->traceNames.push_back(Tracer::intern(plugin->getName()));
+    }
+
+    // Release each consumed key after its last reader
+    chain->releaseAfter.resize(chain->plugins.size());
+    chain->wantedAfter.resize(chain->plugins.size());
+    QSet<QString> produced;
+    for (int i = static_cast<int>(chain->plugins.size()) - 1; i >= 0; --i) {
+        chain->wantedAfter[i] = chain->consumedKeys;
+        for (const QString& key : chain->plugins[i]->consumedKeys()) {
+            if (!chain->consumedKeys.contains(key)) {
+                chain->consumedKeys.insert(key);
+                chain->releaseAfter[i].append(key);
+            }
+        }
+        for (const QString& key : chain->plugins[i]->producedKeys()) {
+            produced.insert(key);
+        }
+    }
+    for (const QString& key : chain->consumedKeys) {
+        if (!produced.contains(key)) {
+            qWarning() << "[VideoPluginManager] No enabled plugin produces" << key;
         }
     }
 
-    qDebug() << "[VideoPluginManager] Cache updated:"
-             << m_enabledPlugins.size() << "enabled plugins out of"
-             << m_plugins.size() << "total";
+    size_t enabledCount = chain->plugins.size();
+
+    {
+        QMutexLocker locker(&m_chainWriteMutex);
+        m_chain.publish(std::move(chain));
+    }
+
+    LOG_DEBUG("VideoPluginManager", "Cache updated: %1 enabled plugins out of %2 total",
+              enabledCount, m_plugins.size());
 }
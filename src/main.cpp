@@ -1,4 +1,5 @@
 #include "ui/mainwindow.h"
+#include "core/metricsdumper.h"
 
 #include <QApplication>
 #include <QDebug>
@@ -10,6 +11,16 @@ int main(int argc, char *argv[])
     qDebug() << "OpenCV Version:" << CV_VERSION;
 
     QApplication a(argc, argv);
+
+    // Unattended runs: periodic metric snapshots as JSON lines
+    const QString metricsFile = qEnvironmentVariable("BLAZESTUDIO_METRICS_FILE");
+    if (!metricsFile.isEmpty()) {
+        bool ok = false;
+        int intervalMs = qEnvironmentVariableIntValue("BLAZESTUDIO_METRICS_INTERVAL_MS", &ok);
+        auto* dumper = new MetricsDumper(&a);
+        dumper->start(metricsFile, ok ? intervalMs : 1000);
+    }
+
     MainWindow w;
     w.show();
     return a.exec();
@@ -0,0 +1,200 @@
+#include "core/sharedframering.h"
+#include "plugins/ivideopluginfactory.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPluginLoader>
+#include <opencv2/opencv.hpp>
+#include <memory>
+
+#ifdef __linux__
+#include <signal.h>
+#include <sys/prctl.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+/**
+ * Plugin host: runs one plugin library for RemoteVideoPlugin.
+ *
+ * Usage: blazestudio_pluginhost --ring <name> --plugin <library> [--viewer-pid <pid>]
+ *
+ * Serves requests from the shared frame ring until it is told to shut
+ * down or the viewer goes away.
+ */
+
+namespace {
+
+// Wake up this often while idle (paused video) to check on the viewer
+const int kIdlePollMs = 1000;
+
+#ifdef _WIN32
+// Opened at startup, so the PID cannot be reused by another process meanwhile
+HANDLE g_viewerProcess = nullptr;
+#endif
+
+bool viewerAlive()
+{
+#if defined(_WIN32)
+    // Signaled once the viewer exits, including when it crashes
+    return !g_viewerProcess || WaitForSingleObject(g_viewerProcess, 0) == WAIT_TIMEOUT;
+#elif defined(__linux__)
+    // PR_SET_PDEATHSIG kills us with the viewer
+    return true;
+#else
+    return getppid() != 1;
+#endif
+}
+
+bool handleCommand(IVideoPlugin& plugin, const QJsonObject& command)
+{
+    const QString name = command.value("command").toString();
+
+    if (name == "initialize") {
+        plugin.initialize(command.value("videoInfo").toObject().toVariantMap());
+        // Enabled state is kept by the viewer side proxy
+        plugin.setEnabled(true);
+    } else if (name == "finalize") {
+        plugin.finalize();
+    } else if (name == "playbackStarted") {
+        plugin.onPlaybackStarted();
+    } else if (name == "playbackPaused") {
+        plugin.onPlaybackPaused();
+    } else if (name == "playbackStopped") {
+        plugin.onPlaybackStopped();
+    } else if (name == "seek") {
+        plugin.onSeek(static_cast<qint64>(command.value("position").toDouble()));
+    } else if (name == "setSettings") {
+        plugin.setSettings(command.value("settings").toObject().toVariantMap());
+    } else {
+        qWarning() << "[PluginHost] Unknown command:" << name;
+        return false;
+    }
+    return true;
+}
+
+bool handleFrame(IVideoPlugin& plugin, SharedFrameRing& ring, SharedFrameHeader* header)
+{
+    if (header->slot < 0 || static_cast<uint32_t>(header->slot) >= ring.slotCount()) {
+        return false;
+    }
+
+    // Works directly on the shared slot
+    cv::Mat shared(header->rows, header->cols, header->type,
+                   ring.slot(static_cast<uint32_t>(header->slot)), static_cast<size_t>(header->step));
+    cv::Mat frame = shared;
+
+    bool success = plugin.processFrame(frame, header->timestamp, header->frameIndex);
+
+    if (frame.data != shared.data) {
+        // The plugin produced a new buffer; it must still fit the slot
+        if (frame.size() != shared.size() || frame.type() != shared.type()) {
+            qWarning() << "[PluginHost] Plugin changed frame size or type, result dropped";
+            return false;
+        }
+        frame.copyTo(shared);
+    }
+
+    header->modified = plugin.frameAccess() == IVideoPlugin::FrameAccess::ReadWrite ? 1 : 0;
+    return success;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+#ifdef __linux__
+    // Don't outlive the viewer
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+#endif
+
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addOption(QCommandLineOption("ring", "Shared frame ring name", "name"));
+    parser.addOption(QCommandLineOption("plugin", "Plugin library path", "path"));
+    parser.addOption(QCommandLineOption("viewer-pid", "Process to exit with", "pid"));
+    parser.process(app);
+
+#ifdef _WIN32
+    if (parser.isSet("viewer-pid")) {
+        DWORD viewerPid = parser.value("viewer-pid").toULong();
+        g_viewerProcess = OpenProcess(SYNCHRONIZE, FALSE, viewerPid);
+        if (!g_viewerProcess) {
+            qWarning() << "[PluginHost] Viewer" << viewerPid << "not found, exiting";
+            return 1;
+        }
+    } else {
+        qWarning() << "[PluginHost] No --viewer-pid, will not notice the viewer exiting";
+    }
+#endif
+
+    SharedFrameRing ring;
+    if (!ring.attach(parser.value("ring").toStdString())) {
+        qWarning() << "[PluginHost] Failed to attach to ring" << parser.value("ring");
+        return 1;
+    }
+
+    QPluginLoader loader(parser.value("plugin"));
+    auto* factory = qobject_cast<IVideoPluginFactory*>(loader.instance());
+    if (!factory) {
+        qWarning() << "[PluginHost] Failed to load plugin:" << loader.errorString();
+        return 1;
+    }
+
+    std::shared_ptr<IVideoPlugin> plugin = factory->createPlugin();
+    if (!plugin) {
+        qWarning() << "[PluginHost] Plugin library did not create a plugin";
+        return 1;
+    }
+
+    qDebug() << "[PluginHost] Serving" << plugin->getName();
+
+    SharedFrameHeader* header = ring.header();
+    // Start from the last answer: the first request may already be waiting
+    uint32_t lastSeen = header->responseSeq.load(std::memory_order_acquire);
+
+    for (;;) {
+        if (!ring.waitRequest(lastSeen, kIdlePollMs)) {
+            if (!viewerAlive()) {
+                qWarning() << "[PluginHost] Viewer gone, exiting";
+                break;
+            }
+            continue;
+        }
+        lastSeen = header->requestSeq.load(std::memory_order_acquire);
+
+        bool success = false;
+        try {
+            switch (header->kind) {
+            case SharedFrameHeader::Frame:
+                success = handleFrame(*plugin, ring, header);
+                break;
+            case SharedFrameHeader::Command: {
+                QByteArray payload(header->payload, static_cast<int>(header->payloadBytes));
+                success = handleCommand(*plugin, QJsonDocument::fromJson(payload).object());
+                break;
+            }
+            case SharedFrameHeader::Shutdown:
+                header->status = 1;
+                ring.postResponse();
+                plugin.reset();
+                return 0;
+            default:
+                break;
+            }
+        } catch (const std::exception& e) {
+            qWarning() << "[PluginHost] Exception in plugin:" << e.what();
+            success = false;
+        }
+
+        header->status = success ? 1 : 0;
+        ring.postResponse();
+    }
+
+    return 0;
+}
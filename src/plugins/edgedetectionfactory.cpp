@@ -0,0 +1,21 @@
+#include "plugins/ivideopluginfactory.h"
+#include "plugins/edgedetectionplugin.h"
+#include <QObject>
+
+/**
+ * @brief Exports EdgeDetectionPlugin from the blazestudio_edgedetection library
+ */
+class EdgeDetectionPluginFactory : public QObject, public IVideoPluginFactory
+{
+    Q_OBJECT
+    Q_PLUGIN_METADATA(IID IVideoPluginFactory_iid FILE "edgedetectionplugin.json")
+    Q_INTERFACES(IVideoPluginFactory)
+
+public:
+    std::shared_ptr<IVideoPlugin> createPlugin() override
+    {
+        return std::make_shared<EdgeDetectionPlugin>();
+    }
+};
+
+#include "edgedetectionfactory.moc"
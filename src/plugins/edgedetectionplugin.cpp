@@ -1,56 +1,139 @@
 #include "plugins/edgedetectionplugin.h"
 #include <QDebug>
 #include <QColor>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Rows per tile; a 4K RGB tile plus its gray/edge planes stays in L2
+const int kTileRows = 64;
+
+// Extra rows read around a tile: blur (2) + Sobel (1) + non-maximum
+// suppression (1), rounded up. Hysteresis is tile local, so an edge chain
+// that only connects through a neighbouring tile can end at the boundary.
+const int kTileHalo = 8;
+
+// Incremental mode works on square tiles; the motion mask is downscaled by
+// kMotionScale, so each tile maps onto an 8x8 block of the mask
+const int kIncrementalTileSize = 64;
+const int kMotionScale = 8;
+
+// Gray level change (on the downscaled mask) that counts as motion
+const int kMotionThreshold = 12;
+
+// Per-thread scratch reused between tiles and frames
+struct TileScratch
+{
+    cv::Mat blurred;
+    cv::Mat edges;
+};
+
+TileScratch& tileScratch()
+{
+    static thread_local TileScratch scratch;
+    return scratch;
+}
+
+} // namespace
 
 EdgeDetectionPlugin::EdgeDetectionPlugin()
     : m_enabled(false)  // Disabled by default (heavy effect)
-    , m_lowThreshold(50)
-    , m_highThreshold(150)
-    , m_viewMode(ViewMode::Blend)
-    , m_blendAlpha(0.5)
-    , m_edgeColor(0, 255, 0)  // Green
-    , m_useColorEdges(true)
+    , m_edgesValid(false)
+    , m_lastLowThreshold(-1)
+    , m_lastHighThreshold(-1)
+    , m_recomputedFraction(1.0)
+    , m_scratchCharge(MemorySubsystem::PluginScratch)
 {
 }
 
+void EdgeDetectionPlugin::setHost(IPluginHost* host)
+{
+    m_scratchCharge.setHost(host);
+}
+
 bool EdgeDetectionPlugin::processFrame(cv::Mat& frame, qint64 timestamp, qint64 frameIndex)
+{
+    FrameContext context(timestamp, frameIndex);
+    return processFrame(frame, context);
+}
+
+bool EdgeDetectionPlugin::processFrame(cv::Mat& frame, FrameContext& context)
 {
     if (!m_enabled || frame.empty()) {
         return false;
     }
 
-    cv::Mat edges;
-    detectEdges(frame, edges);
+    // One consistent parameter set for the whole frame
+    const Settings& settings = m_settings.acquire();
 
-    switch (m_viewMode) {
-        case ViewMode::Original:
-            // Do nothing, keep original
-            break;
+    // Nothing to show, skip detection entirely
+    if (settings.viewMode == ViewMode::Original) {
+        return true;
+    }
 
-        case ViewMode::Edges:
-            // Show only edges
-            if (m_useColorEdges) {
-                applyColorToEdges(edges);
-            }
-            // Convert edges to RGB if necessary
-            if (edges.channels() == 1) {
-                cv::cvtColor(edges, frame, cv::COLOR_GRAY2RGB);
-            } else {
-                frame = edges;
-            }
-            break;
-
-        case ViewMode::Blend:
-            // Blend edges with original image
-            if (m_useColorEdges) {
-                applyColorToEdges(edges);
-            } else {
-                cv::cvtColor(edges, edges, cv::COLOR_GRAY2RGB);
-            }
-            cv::addWeighted(frame, 1.0 - m_blendAlpha, edges, m_blendAlpha, 0, frame);
-            break;
+    // The fused kernel works on 8-bit RGB
+    if (frame.type() != CV_8UC3) {
+        if (frame.channels() == 4) {
+            cv::cvtColor(frame, frame, cv::COLOR_RGBA2RGB);
+        } else if (frame.channels() == 1) {
+            cv::cvtColor(frame, frame, cv::COLOR_GRAY2RGB);
+        } else {
+            return false;
+        }
     }
 
+    const int tiles = (frame.rows + kTileRows - 1) / kTileRows;
+
+    // A consumer kept last frame's gray alive, don't overwrite it
+    if (m_gray.u && m_gray.u->refcount > 1) {
+        m_gray.release();
+    }
+    m_gray.create(frame.size(), CV_8UC1);
+
+    // Pass 1: RGB -> gray per tile. The frame is only read here, so the
+    // second pass can look at neighbouring rows without racing writers.
+    cv::parallel_for_(cv::Range(0, tiles), [&](const cv::Range& range) {
+        int y0 = range.start * kTileRows;
+        int y1 = std::min(frame.rows, range.end * kTileRows);
+        cv::Mat gray = m_gray.rowRange(y0, y1);
+        cv::cvtColor(frame.rowRange(y0, y1), gray, cv::COLOR_RGB2GRAY);
+    });
+
+    // Shares the buffer, consumers read it without a copy
+    if (context.wants(FrameKeys::Gray)) {
+        context.publish<cv::Mat>(FrameKeys::Gray, std::make_shared<const cv::Mat>(m_gray));
+    }
+
+    if (settings.incremental) {
+        detectEdgesIncremental(frame, settings);
+        updateScratchCharge();
+        return true;
+    }
+
+    m_edgesValid = false;
+    m_recomputedFraction = 1.0;
+
+    // Pass 2: blur, Canny, colorize and blend per tile while it is cache resident
+    cv::parallel_for_(cv::Range(0, tiles), [&](const cv::Range& range) {
+        TileScratch& scratch = tileScratch();
+
+        for (int tile = range.start; tile < range.end; ++tile) {
+            int y0 = tile * kTileRows;
+            int y1 = std::min(frame.rows, y0 + kTileRows);
+            int top = std::max(0, y0 - kTileHalo);
+            int bottom = std::min(frame.rows, y1 + kTileHalo);
+
+            cv::GaussianBlur(m_gray.rowRange(top, bottom), scratch.blurred, cv::Size(5, 5), 1.4);
+            cv::Canny(scratch.blurred, scratch.edges, settings.lowThreshold, settings.highThreshold);
+
+            cv::Mat tileFrame = frame.rowRange(y0, y1);
+            applyColorToEdges(tileFrame, scratch.edges.rowRange(y0 - top, y1 - top), settings);
+        }
+    });
+
+    updateScratchCharge();
     return true;
 }
 
@@ -59,10 +142,18 @@ void EdgeDetectionPlugin::initialize(const QVariantMap& videoInfo)
     int width = videoInfo.value("width", 0).toInt();
     int height = videoInfo.value("height", 0).toInt();
     
+    m_edgesValid = false;
+
     qDebug() << "[EdgeDetectionPlugin] Initialized for video"
              << width << "x" << height;
 }
 
+void EdgeDetectionPlugin::onSeek(qint64 position)
+{
+    // The previous edge map belongs to another part of the video
+    m_edgesValid = false;
+}
+
 void EdgeDetectionPlugin::finalize()
 {
     qDebug() << "[EdgeDetectionPlugin] Finalized";
@@ -96,120 +187,269 @@ void EdgeDetectionPlugin::setEnabled(bool enabled)
 
 void EdgeDetectionPlugin::setSettings(const QVariantMap& settings)
 {
-    m_lowThreshold = settings.value("lowThreshold", 50).toInt();
-    m_highThreshold = settings.value("highThreshold", 150).toInt();
-    m_blendAlpha = settings.value("blendAlpha", 0.5).toDouble();
-    m_useColorEdges = settings.value("useColorEdges", true).toBool();
+    Settings next;
+    next.lowThreshold = settings.value("lowThreshold", 50).toInt();
+    next.highThreshold = settings.value("highThreshold", 150).toInt();
+    next.blendAlpha = settings.value("blendAlpha", 0.5).toDouble();
+    next.useColorEdges = settings.value("useColorEdges", true).toBool();
+    next.incremental = settings.value("incremental", false).toBool();
+    if (next.incremental != m_settings.published().incremental) {
+        m_edgesValid = false;
+    }
     
     // ViewMode como string
     QString modeStr = settings.value("viewMode", "blend").toString().toLower();
     if (modeStr == "original") {
-        m_viewMode = ViewMode::Original;
+        next.viewMode = ViewMode::Original;
     } else if (modeStr == "edges") {
-        m_viewMode = ViewMode::Edges;
+        next.viewMode = ViewMode::Edges;
     } else {
-        m_viewMode = ViewMode::Blend;
+        next.viewMode = ViewMode::Blend;
     }
     
     // Cor das bordas
     if (settings.contains("edgeColor")) {
         QColor color = settings.value("edgeColor").value<QColor>();
-        m_edgeColor = cv::Scalar(color.blue(), color.green(), color.red());
+        next.edgeColor = cv::Scalar(color.blue(), color.green(), color.red());
+    } else {
+        next.edgeColor = m_settings.published().edgeColor;
     }
+
+    m_settings.publish(next);
 }
 
 QVariantMap EdgeDetectionPlugin::getSettings() const
 {
+    const Settings& current = m_settings.published();
+
     QVariantMap settings;
-    settings["lowThreshold"] = m_lowThreshold;
-    settings["highThreshold"] = m_highThreshold;
-    settings["blendAlpha"] = m_blendAlpha;
-    settings["useColorEdges"] = m_useColorEdges;
+    settings["lowThreshold"] = current.lowThreshold;
+    settings["highThreshold"] = current.highThreshold;
+    settings["blendAlpha"] = current.blendAlpha;
+    settings["useColorEdges"] = current.useColorEdges;
+    settings["incremental"] = current.incremental;
     
     QString modeStr;
-    switch (m_viewMode) {
+    switch (current.viewMode) {
         case ViewMode::Original: modeStr = "original"; break;
         case ViewMode::Edges: modeStr = "edges"; break;
         case ViewMode::Blend: modeStr = "blend"; break;
     }
     settings["viewMode"] = modeStr;
     
-    QColor color(m_edgeColor[2], m_edgeColor[1], m_edgeColor[0]);
+    QColor color(current.edgeColor[2], current.edgeColor[1], current.edgeColor[0]);
     settings["edgeColor"] = color;
+
+    if (current.incremental) {
+        settings["status"] = QString("%1% of tiles recomputed")
+                                 .arg(recomputedTileFraction() * 100.0, 0, 'f', 0);
+    }
     
     return settings;
 }
 
+QStringList EdgeDetectionPlugin::producedKeys() const
+{
+    return QStringList{FrameKeys::Gray};
+}
+
 int EdgeDetectionPlugin::getPriority() const
 {
     return 200; // Execute before overlays, but after preprocessing
 }
 
+bool EdgeDetectionPlugin::isVisualPlugin() const
+{
+    // Edges are only visualized, display resolution is enough
+    return true;
+}
+
 void EdgeDetectionPlugin::setThresholds(int low, int high)
 {
-    m_lowThreshold = qBound(0, low, 255);
-    m_highThreshold = qBound(0, high, 255);
+    low = qBound(0, low, 255);
+    high = qBound(0, high, 255);
     
     // Ensure that high >= low
-    if (m_highThreshold < m_lowThreshold) {
-        std::swap(m_lowThreshold, m_highThreshold);
+    if (high < low) {
+        std::swap(low, high);
     }
     
-    qDebug() << "[EdgeDetectionPlugin] Thresholds:" << m_lowThreshold << "-" << m_highThreshold;
+    m_settings.update([low, high](Settings& settings) {
+        settings.lowThreshold = low;
+        settings.highThreshold = high;
+    });
+
+    qDebug() << "[EdgeDetectionPlugin] Thresholds:" << low << "-" << high;
 }
 
 void EdgeDetectionPlugin::setViewMode(ViewMode mode)
 {
-    m_viewMode = mode;
+    m_settings.update([mode](Settings& settings) {
+        settings.viewMode = mode;
+    });
 }
 
 void EdgeDetectionPlugin::setBlendAlpha(double alpha)
 {
-    m_blendAlpha = qBound(0.0, alpha, 1.0);
+    alpha = qBound(0.0, alpha, 1.0);
+    m_settings.update([alpha](Settings& settings) {
+        settings.blendAlpha = alpha;
+    });
 }
 
 void EdgeDetectionPlugin::setEdgeColor(const cv::Scalar& color)
 {
-    m_edgeColor = color;
-    m_useColorEdges = true;
+    m_settings.update([&color](Settings& settings) {
+        settings.edgeColor = color;
+        settings.useColorEdges = true;
+    });
+}
+
+void EdgeDetectionPlugin::setIncrementalMode(bool incremental)
+{
+    // Edges kept from before the switch may not match the frames any more
+    m_edgesValid = false;
+    m_settings.update([incremental](Settings& settings) {
+        settings.incremental = incremental;
+    });
+}
+
+double EdgeDetectionPlugin::recomputedTileFraction() const
+{
+    return m_recomputedFraction;
+}
+
+void EdgeDetectionPlugin::updateScratchCharge()
+{
+    qint64 bytes = 0;
+    for (const cv::Mat* buffer : {&m_gray, &m_edges, &m_referenceGray}) {
+        bytes += static_cast<qint64>(buffer->total() * buffer->elemSize());
+    }
+    m_scratchCharge.set(bytes);
 }
 
-void EdgeDetectionPlugin::detectEdges(const cv::Mat& input, cv::Mat& output)
+void EdgeDetectionPlugin::detectEdgesIncremental(cv::Mat& frame, const Settings& settings)
 {
-    // Convert to grayscale
-    cv::Mat gray;
-    if (input.channels() == 3) {
-        cv::cvtColor(input, gray, cv::COLOR_RGB2GRAY);
-    } else if (input.channels() == 4) {
-        cv::cvtColor(input, gray, cv::COLOR_RGBA2GRAY);
+    const cv::Size motionSize(std::max(1, frame.cols / kMotionScale),
+                              std::max(1, frame.rows / kMotionScale));
+    cv::Mat motionGray;
+    cv::resize(m_gray, motionGray, motionSize, 0, 0, cv::INTER_AREA);
+
+    const int tilesX = (frame.cols + kIncrementalTileSize - 1) / kIncrementalTileSize;
+    const int tilesY = (frame.rows + kIncrementalTileSize - 1) / kIncrementalTileSize;
+    const int motionTile = kIncrementalTileSize / kMotionScale;
+
+    // Anything that invalidates the whole edge map forces every tile
+    bool fullRecompute = !m_edgesValid
+                      || m_edges.size() != frame.size()
+                      || m_referenceGray.size() != motionSize
+                      || m_lastLowThreshold != settings.lowThreshold
+                      || m_lastHighThreshold != settings.highThreshold;
+
+    cv::Mat changedTiles(tilesY, tilesX, CV_8UC1, cv::Scalar(fullRecompute ? 255 : 0));
+
+    if (!fullRecompute) {
+        // Compare against the gray level each tile was last computed from,
+        // so slow changes accumulate instead of slipping under the threshold
+        cv::Mat motion;
+        cv::absdiff(motionGray, m_referenceGray, motion);
+        cv::threshold(motion, motion, kMotionThreshold, 255, cv::THRESH_BINARY);
+
+        for (int ty = 0; ty < tilesY; ++ty) {
+            for (int tx = 0; tx < tilesX; ++tx) {
+                cv::Rect cell = cv::Rect(tx * motionTile, ty * motionTile, motionTile, motionTile)
+                              & cv::Rect(0, 0, motion.cols, motion.rows);
+                if (!cell.empty() && cv::countNonZero(motion(cell)) > 0) {
+                    changedTiles.at<uchar>(ty, tx) = 255;
+                }
+            }
+        }
+
+        // Moving edges also affect the Canny result of neighbouring tiles
+        cv::dilate(changedTiles, changedTiles, cv::Mat());
     } else {
-        gray = input.clone();
+        m_edges.create(frame.size(), CV_8UC1);
+        m_referenceGray.create(motionSize, CV_8UC1);
     }
-    
-    // Apply blur to reduce noise
-    cv::GaussianBlur(gray, gray, cv::Size(5, 5), 1.4);
-    
-    // Detect edges with Canny
-    cv::Canny(gray, output, m_lowThreshold, m_highThreshold);
+
+    std::vector<cv::Rect> tiles;
+    for (int ty = 0; ty < tilesY; ++ty) {
+        for (int tx = 0; tx < tilesX; ++tx) {
+            if (changedTiles.at<uchar>(ty, tx)) {
+                tiles.emplace_back(tx * kIncrementalTileSize, ty * kIncrementalTileSize,
+                                   kIncrementalTileSize, kIncrementalTileSize);
+            }
+        }
+    }
+
+    // Re-run blur and Canny on the changed tiles only; tiles write disjoint
+    // parts of the edge map and the reference mask
+    const cv::Rect frameRect(0, 0, frame.cols, frame.rows);
+    const cv::Rect motionRect(0, 0, motionSize.width, motionSize.height);
+    cv::parallel_for_(cv::Range(0, static_cast<int>(tiles.size())), [&](const cv::Range& range) {
+        TileScratch& scratch = tileScratch();
+
+        for (int i = range.start; i < range.end; ++i) {
+            cv::Rect tile = tiles[i] & frameRect;
+            cv::Rect haloRect = cv::Rect(tile.x - kTileHalo, tile.y - kTileHalo,
+                                         tile.width + 2 * kTileHalo, tile.height + 2 * kTileHalo)
+                              & frameRect;
+
+            cv::GaussianBlur(m_gray(haloRect), scratch.blurred, cv::Size(5, 5), 1.4);
+            cv::Canny(scratch.blurred, scratch.edges, settings.lowThreshold, settings.highThreshold);
+
+            cv::Rect inner(tile.tl() - haloRect.tl(), tile.size());
+            scratch.edges(inner).copyTo(m_edges(tile));
+
+            cv::Rect cell = cv::Rect(tile.x / kMotionScale, tile.y / kMotionScale, motionTile, motionTile)
+                          & motionRect;
+            if (!cell.empty()) {
+                motionGray(cell).copyTo(m_referenceGray(cell));
+            }
+        }
+    });
+
+    m_edgesValid = true;
+    m_lastLowThreshold = settings.lowThreshold;
+    m_lastHighThreshold = settings.highThreshold;
+    m_recomputedFraction = static_cast<double>(tiles.size()) / (tilesX * tilesY);
+
+    // The frame itself is new every time, so colorize and blend all of it
+    const int bands = (frame.rows + kTileRows - 1) / kTileRows;
+    cv::parallel_for_(cv::Range(0, bands), [&](const cv::Range& range) {
+        int y0 = range.start * kTileRows;
+        int y1 = std::min(frame.rows, range.end * kTileRows);
+        cv::Mat bandFrame = frame.rowRange(y0, y1);
+        applyColorToEdges(bandFrame, m_edges.rowRange(y0, y1), settings);
+    });
 }
 
-void EdgeDetectionPlugin::applyColorToEdges(cv::Mat& edges)
+void EdgeDetectionPlugin::applyColorToEdges(cv::Mat& frame, const cv::Mat& edges, const Settings& settings)
 {
-    // Convert edges to RGB
-    cv::Mat colorEdges;
-    cv::cvtColor(edges, colorEdges, cv::COLOR_GRAY2RGB);
-    
-    // Apply custom color
-    for (int i = 0; i < colorEdges.rows; i++) {
-        for (int j = 0; j < colorEdges.cols; j++) {
-            cv::Vec3b& pixel = colorEdges.at<cv::Vec3b>(i, j);
-            if (pixel[0] > 0) {  // If is an edge (white)
-                pixel[0] = m_edgeColor[0];
-                pixel[1] = m_edgeColor[1];
-                pixel[2] = m_edgeColor[2];
+    CV_Assert(frame.type() == CV_8UC3 && edges.type() == CV_8UC1 && frame.size() == edges.size());
+
+    // Edges mode is a blend with alpha 1 (black background, colored edges)
+    double alpha = (settings.viewMode == ViewMode::Edges) ? 1.0 : settings.blendAlpha;
+    cv::Scalar color = settings.useColorEdges ? settings.edgeColor : cv::Scalar(255, 255, 255);
+
+    // 8.8 fixed point: out = src * (1 - alpha) + (edge ? color * alpha : 0)
+    const unsigned int keep = static_cast<unsigned int>(std::lround((1.0 - alpha) * 256.0));
+    unsigned int add[3];
+    for (int c = 0; c < 3; ++c) {
+        add[c] = static_cast<unsigned int>(std::lround(qBound(0.0, color[c], 255.0) * alpha));
+    }
+
+    // Branchless, single pass over frame and mask (auto-vectorizes)
+    for (int y = 0; y < frame.rows; ++y) {
+        uchar* dst = frame.ptr<uchar>(y);
+        const uchar* mask = edges.ptr<uchar>(y);
+
+        for (int x = 0; x < frame.cols; ++x) {
+            unsigned int select = 0u - static_cast<unsigned int>(mask[x] != 0);
+            for (int c = 0; c < 3; ++c) {
+                unsigned int value = ((dst[3 * x + c] * keep + 128u) >> 8) + (add[c] & select);
+                dst[3 * x + c] = static_cast<uchar>(std::min(value, 255u));
             }
         }
     }
-    
-    edges = colorEdges;
 }
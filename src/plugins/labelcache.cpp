@@ -0,0 +1,213 @@
+#include "plugins/labelcache.h"
+#include <QHash>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace {
+
+// Exact round(value / 255) for value in [0, 255 * 255]
+inline unsigned int divide255(unsigned int value)
+{
+    value += 128;
+    return (value + (value >> 8)) >> 8;
+}
+
+} // namespace
+
+bool LabelCache::Key::operator==(const Key& other) const
+{
+    return fontFace == other.fontFace
+        && scaleMilli == other.scaleMilli
+        && thickness == other.thickness
+        && color == other.color
+        && opacity == other.opacity
+        && text == other.text;
+}
+
+size_t LabelCache::KeyHash::operator()(const Key& key) const
+{
+    size_t hash = qHash(key.text);
+    auto combine = [&hash](size_t value) {
+        hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+    combine(static_cast<size_t>(key.fontFace));
+    combine(static_cast<size_t>(key.scaleMilli));
+    combine(static_cast<size_t>(key.thickness));
+    combine((static_cast<size_t>(key.color[0]) << 16)
+            | (static_cast<size_t>(key.color[1]) << 8)
+            | key.color[2]);
+    combine(static_cast<size_t>(key.opacity));
+    return hash;
+}
+
+LabelCache::LabelCache(size_t capacity)
+    : m_capacity(std::max<size_t>(1, capacity))
+    , m_hits(0)
+    , m_misses(0)
+    , m_bytes(0)
+    , m_charge(MemorySubsystem::Caches)
+{
+}
+
+const LabelBitmap& LabelCache::get(const QString& text, int fontFace, double fontScale,
+                                   int thickness, const cv::Vec3b& color, double backgroundOpacity)
+{
+    Key key = makeKey(text, fontFace, fontScale, thickness, color, backgroundOpacity);
+
+    auto it = m_labels.find(key);
+    if (it != m_labels.end()) {
+        ++m_hits;
+        m_recency.splice(m_recency.begin(), m_recency, it->second.recency);
+        return it->second.bitmap;
+    }
+
+    ++m_misses;
+    size_t capacity = m_capacity;
+    if (MemoryAccountant::instance().shouldEvict()) {
+        capacity = std::max<size_t>(1, m_capacity / 4);
+    }
+    while (!m_labels.empty() && m_labels.size() >= capacity) {
+        evictLeastRecentlyUsed();
+    }
+
+    Entry entry;
+    entry.bitmap = renderKey(key);
+    m_recency.push_front(key);
+    entry.recency = m_recency.begin();
+    m_bytes += bitmapBytes(entry.bitmap);
+    m_charge.set(m_bytes);
+    return m_labels.emplace(std::move(key), std::move(entry)).first->second.bitmap;
+}
+
+LabelBitmap LabelCache::render(const QString& text, int fontFace, double fontScale,
+                               int thickness, const cv::Vec3b& color, double backgroundOpacity)
+{
+    return renderKey(makeKey(text, fontFace, fontScale, thickness, color, backgroundOpacity));
+}
+
+void LabelCache::composite(cv::Mat& frame, const LabelBitmap& label, const cv::Point& origin)
+{
+    CV_Assert(frame.type() == CV_8UC3);
+
+    cv::Rect labelRect(origin + label.offset, label.scale.size());
+    cv::Rect visible = labelRect & cv::Rect(0, 0, frame.cols, frame.rows);
+    if (visible.empty()) {
+        return;
+    }
+
+    cv::Rect source(visible.tl() - labelRect.tl(), visible.size());
+    cv::Mat roi = frame(visible);
+    cv::Mat scale = label.scale(source);
+    cv::Mat addend = label.addend(source);
+
+    // One multiply-add per channel, no temporaries
+    for (int y = 0; y < roi.rows; ++y) {
+        uchar* dst = roi.ptr<uchar>(y);
+        const uchar* s = scale.ptr<uchar>(y);
+        const uchar* a = addend.ptr<uchar>(y);
+
+        for (int x = 0; x < roi.cols; ++x) {
+            unsigned int keep = s[x];
+            for (int c = 0; c < 3; ++c) {
+                unsigned int value = divide255(dst[3 * x + c] * keep) + a[3 * x + c];
+                dst[3 * x + c] = static_cast<uchar>(std::min(value, 255u));
+            }
+        }
+    }
+}
+
+void LabelCache::clear()
+{
+    m_labels.clear();
+    m_recency.clear();
+    m_bytes = 0;
+    m_charge.set(0);
+}
+
+size_t LabelCache::size() const
+{
+    return m_labels.size();
+}
+
+quint64 LabelCache::hits() const
+{
+    return m_hits;
+}
+
+quint64 LabelCache::misses() const
+{
+    return m_misses;
+}
+
+LabelCache::Key LabelCache::makeKey(const QString& text, int fontFace, double fontScale,
+                                    int thickness, const cv::Vec3b& color, double backgroundOpacity)
+{
+    return Key{text, fontFace, static_cast<int>(std::lround(fontScale * 1000.0)), thickness, color,
+               static_cast<int>(std::lround(qBound(0.0, backgroundOpacity, 1.0) * 255.0))};
+}
+
+LabelBitmap LabelCache::renderKey(const Key& key)
+{
+    const int padding = 5;
+    double fontScale = key.scaleMilli / 1000.0;
+
+    // Only converted when a label is rendered, never on a hit
+    const std::string text = key.text.toStdString();
+
+    int baseline = 0;
+    cv::Size textSize = cv::getTextSize(text, key.fontFace, fontScale, key.thickness, &baseline);
+
+    // Box matches the previous drawText layout; descenders may extend below it
+    int boxHeight = textSize.height + 2 * padding;
+    cv::Size canvasSize(textSize.width + 2 * padding, boxHeight + baseline);
+
+    cv::Mat coverage = cv::Mat::zeros(canvasSize, CV_8UC1);
+    cv::putText(coverage, text, cv::Point(padding, padding + textSize.height),
+                key.fontFace, fontScale, cv::Scalar(255), key.thickness, cv::LINE_AA);
+
+    LabelBitmap bitmap;
+    bitmap.offset = cv::Point(-padding, -textSize.height - padding);
+    bitmap.scale.create(canvasSize, CV_8UC1);
+    bitmap.addend.create(canvasSize, CV_8UC3);
+
+    for (int y = 0; y < canvasSize.height; ++y) {
+        const uchar* cov = coverage.ptr<uchar>(y);
+        uchar* scale = bitmap.scale.ptr<uchar>(y);
+        uchar* addend = bitmap.addend.ptr<uchar>(y);
+        unsigned int background = (y < boxHeight) ? static_cast<unsigned int>(key.opacity) : 0u;
+
+        for (int x = 0; x < canvasSize.width; ++x) {
+            unsigned int c = cov[x];
+            // dst' = dst * (1 - bg) * (1 - c) + color * c
+            scale[x] = static_cast<uchar>(divide255((255 - background) * (255 - c)));
+            for (int ch = 0; ch < 3; ++ch) {
+                addend[3 * x + ch] = static_cast<uchar>(divide255(key.color[ch] * c));
+            }
+        }
+    }
+
+    return bitmap;
+}
+
+void LabelCache::evictLeastRecentlyUsed()
+{
+    if (m_recency.empty()) {
+        return;
+    }
+
+    auto oldest = m_labels.find(m_recency.back());
+    if (oldest != m_labels.end()) {
+        m_bytes -= bitmapBytes(oldest->second.bitmap);
+        m_charge.set(m_bytes);
+        m_labels.erase(oldest);
+    }
+    m_recency.pop_back();
+}
+
+qint64 LabelCache::bitmapBytes(const LabelBitmap& bitmap)
+{
+    return static_cast<qint64>(bitmap.scale.total() * bitmap.scale.elemSize()
+                               + bitmap.addend.total() * bitmap.addend.elemSize());
+}
@@ -1,63 +1,114 @@
 #include "plugins/overlayvideoplugin.h"
 #include <QDebug>
-#include <QDateTime>
+#include <chrono>
 #include <opencv2/imgproc.hpp>
 
+namespace {
+
+const qint64 kHealthRefreshMs = 500; // Rates are averaged over at least this window
+
+qint64 steadyNowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
 OverlayVideoPlugin::OverlayVideoPlugin()
     : m_enabled(true)
     , m_videoWidth(0)
     , m_videoHeight(0)
     , m_videoFps(0.0)
     , m_videoDuration(0)
-    , m_showFPS(true)
-    , m_showTimestamp(false)  // Disabled by default for performance
-    , m_showFrameCount(false)  // Disabled by default for performance
-    , m_showResolution(false)
-    , m_textColor(Qt::white)
-    , m_backgroundOpacity(0.5)
     , m_isPlaying(false)
-    , m_lastFrameTime(0)
     , m_currentFPS(0.0)
+    , m_decodeFPS(0.0)
+    , m_pluginFPS(0.0)
+    , m_droppedFrames(0)
+    , m_presentLagMs(0.0)
+    , m_avDriftMs(0.0)
+    , m_residentBytes(0)
+    , m_accountedBytes(0)
+    , m_memoryBudget(0)
     , m_frameCounter(0)
+    , m_rasterOverlay(false)
 {
 }
 
 bool OverlayVideoPlugin::processFrame(cv::Mat& frame, qint64 timestamp, qint64 frameIndex)
+{
+    // Called directly, the frame belongs to the caller
+    return process(frame, timestamp, frameIndex, true);
+}
+
+bool OverlayVideoPlugin::processFrame(cv::Mat& frame, FrameContext& context)
+{
+    return process(frame, context.timestamp(), context.frameIndex(), context.frameWritable());
+}
+
+bool OverlayVideoPlugin::process(cv::Mat& frame, qint64 timestamp, qint64 frameIndex, bool writable)
 {
     if (!m_enabled || frame.empty()) {
         return false;
     }
 
+    // One consistent parameter set for the whole frame (also used by emitOverlay)
+    const Settings& settings = m_settings.acquire();
+
     m_frameCounter++;
-    
-    // Calculate real FPS only every 5 frames (optimization)
-    if (m_frameCounter % 5 == 0) {
-        qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-        if (m_lastFrameTime > 0) {
-            qint64 delta = currentTime - m_lastFrameTime;
-            if (delta > 0) {
-                double instantFPS = 5000.0 / delta;  // 5 frames / delta
-                m_currentFPS = m_currentFPS * 0.8 + instantFPS * 0.2;
-            }
-        }
-        m_lastFrameTime = currentTime;
+
+    // Counters are shared with the rest of the pipeline; sampling them
+    // twice a second is enough for a readable display
+    if (steadyNowMs() - m_lastSnapshot.timestampMs >= kHealthRefreshMs) {
+        refreshHealth();
     }
 
-    // Desenhar overlay
-    drawOverlay(frame, timestamp, frameIndex);
+    // In vector mode the labels are emitted in emitOverlay and drawn by GL.
+    // Right after switching to raster the frame may still be a shared
+    // read-only view; drawing starts with the next frame then.
+    if (!settings.vectorOverlay && writable) {
+        drawOverlay(frame, settings, timestamp, frameIndex);
+    }
 
     return true;
 }
 
+void OverlayVideoPlugin::emitOverlay(OverlayCommandList& overlay, qint64 timestamp, qint64 frameIndex)
+{
+    const Settings& settings = m_settings.current();
+    if (!m_enabled || !settings.vectorOverlay) {
+        return;
+    }
+
+    const float fontSize = 14.0f;
+    const float lineHeight = 26.0f;
+    const float margin = 8.0f;
+    QColor background(0, 0, 0, qRound(settings.backgroundOpacity * 255));
+
+    // Screen space keeps the HUD readable regardless of source resolution
+    float y = margin;
+    for (const InfoLine& line : buildInfoLines(settings, timestamp, frameIndex)) {
+        overlay.addText(line.text, cv::Point2f(margin, y), settings.textColor, fontSize, background,
+                        Qt::AlignLeft | Qt::AlignTop, OverlayCommand::Space::Screen);
+        y += lineHeight;
+    }
+
+    overlay.addText(m_isPlaying ? "PLAYING" : "PAUSED", cv::Point2f(margin, margin),
+                    settings.textColor, fontSize, background,
+                    Qt::AlignRight | Qt::AlignTop, OverlayCommand::Space::Screen);
+}
+
 void OverlayVideoPlugin::initialize(const QVariantMap& videoInfo)
 {
     m_videoWidth = videoInfo.value("width", 0).toInt();
     m_videoHeight = videoInfo.value("height", 0).toInt();
     m_videoFps = videoInfo.value("fps", 0.0).toDouble();
     m_videoDuration = videoInfo.value("duration", 0).toLongLong();
+    m_metricsScope = videoInfo.value("metricsScope").toString();
     
     m_frameCounter = 0;
-    m_lastFrameTime = 0;
+    m_lastSnapshot = MetricsSnapshot();
     m_currentFPS = 0.0;
 
     qDebug() << "[OverlayVideoPlugin] Initialized with video:"
@@ -67,14 +118,17 @@ void OverlayVideoPlugin::initialize(const QVariantMap& videoInfo)
 
 void OverlayVideoPlugin::finalize()
 {
-    qDebug() << "[OverlayVideoPlugin] Finalized. Total frames processed:" << m_frameCounter;
+    qDebug() << "[OverlayVideoPlugin] Finalized. Total frames processed:" << m_frameCounter
+             << "Label cache hits:" << m_labelCache.hits()
+             << "misses:" << m_labelCache.misses();
     m_frameCounter = 0;
+    m_labelCache.clear();
 }
 
 void OverlayVideoPlugin::onPlaybackStarted()
 {
     m_isPlaying = true;
-    m_lastFrameTime = 0;
+    m_lastSnapshot = MetricsSnapshot();
     qDebug() << "[OverlayVideoPlugin] Playback started";
 }
 
@@ -93,10 +147,33 @@ void OverlayVideoPlugin::onPlaybackStopped()
 
 void OverlayVideoPlugin::onSeek(qint64 position)
 {
-    m_lastFrameTime = 0; // Reset FPS calculation
+    m_lastSnapshot = MetricsSnapshot(); // Rates restart after the seek
     qDebug() << "[OverlayVideoPlugin] Seek to position:" << position << "ms";
 }
 
+bool OverlayVideoPlugin::supportsStateSnapshot() const
+{
+    return true;
+}
+
+QVariant OverlayVideoPlugin::snapshotState() const
+{
+    QVariantMap state;
+    state["fps"] = m_currentFPS;
+    state["frameCounter"] = m_frameCounter;
+    return state;
+}
+
+void OverlayVideoPlugin::restoreState(const QVariant& state)
+{
+    // The FPS estimate resumes from the checkpoint instead of ramping up from 0;
+    // timing itself restarts, the wall clock moved on since the checkpoint
+    QVariantMap values = state.toMap();
+    m_currentFPS = values.value("fps", m_currentFPS).toDouble();
+    m_frameCounter = values.value("frameCounter", m_frameCounter).toInt();
+    m_lastSnapshot = MetricsSnapshot();
+}
+
 QString OverlayVideoPlugin::getName() const
 {
     return "Overlay Plugin";
@@ -112,6 +189,12 @@ QString OverlayVideoPlugin::getDescription() const
     return "Draws information about the video (FPS, timestamp, etc)";
 }
 
+IVideoPlugin::FrameAccess OverlayVideoPlugin::frameAccess() const
+{
+    // Vector labels are drawn by GL, the frame is only looked at
+    return m_rasterOverlay ? FrameAccess::ReadWrite : FrameAccess::ReadOnly;
+}
+
 bool OverlayVideoPlugin::isEnabled() const
 {
     return m_enabled;
@@ -124,26 +207,38 @@ void OverlayVideoPlugin::setEnabled(bool enabled)
 
 void OverlayVideoPlugin::setSettings(const QVariantMap& settings)
 {
-    m_showFPS = settings.value("showFPS", true).toBool();
-    m_showTimestamp = settings.value("showTimestamp", true).toBool();
-    m_showFrameCount = settings.value("showFrameCount", true).toBool();
-    m_showResolution = settings.value("showResolution", false).toBool();
-    m_backgroundOpacity = settings.value("backgroundOpacity", 0.5).toDouble();
+    Settings next;
+    next.showFPS = settings.value("showFPS", true).toBool();
+    next.showTimestamp = settings.value("showTimestamp", true).toBool();
+    next.showFrameCount = settings.value("showFrameCount", true).toBool();
+    next.showResolution = settings.value("showResolution", false).toBool();
+    next.showHealth = settings.value("showHealth", false).toBool();
+    next.backgroundOpacity = settings.value("backgroundOpacity", 0.5).toDouble();
+    next.vectorOverlay = settings.value("vectorOverlay", true).toBool();
+    m_rasterOverlay = !next.vectorOverlay;
     
     if (settings.contains("textColor")) {
-        m_textColor = settings.value("textColor").value<QColor>();
+        next.textColor = settings.value("textColor").value<QColor>();
+    } else {
+        next.textColor = m_settings.published().textColor;
     }
+
+    m_settings.publish(next);
 }
 
 QVariantMap OverlayVideoPlugin::getSettings() const
 {
+    const Settings& current = m_settings.published();
+
     QVariantMap settings;
-    settings["showFPS"] = m_showFPS;
-    settings["showTimestamp"] = m_showTimestamp;
-    settings["showFrameCount"] = m_showFrameCount;
-    settings["showResolution"] = m_showResolution;
-    settings["backgroundOpacity"] = m_backgroundOpacity;
-    settings["textColor"] = m_textColor;
+    settings["showFPS"] = current.showFPS;
+    settings["showTimestamp"] = current.showTimestamp;
+    settings["showFrameCount"] = current.showFrameCount;
+    settings["showResolution"] = current.showResolution;
+    settings["showHealth"] = current.showHealth;
+    settings["backgroundOpacity"] = current.backgroundOpacity;
+    settings["textColor"] = current.textColor;
+    settings["vectorOverlay"] = current.vectorOverlay;
     return settings;
 }
 
@@ -152,117 +247,186 @@ int OverlayVideoPlugin::getPriority() const
     return 1000; // Execute last (draw over everything)
 }
 
+bool OverlayVideoPlugin::isVisualPlugin() const
+{
+    // Labels are drawn for display only
+    return true;
+}
+
 void OverlayVideoPlugin::setShowFPS(bool show)
 {
-    m_showFPS = show;
+    m_settings.update([show](Settings& settings) {
+        settings.showFPS = show;
+    });
 }
 
 void OverlayVideoPlugin::setShowTimestamp(bool show)
 {
-    m_showTimestamp = show;
+    m_settings.update([show](Settings& settings) {
+        settings.showTimestamp = show;
+    });
 }
 
 void OverlayVideoPlugin::setShowFrameCount(bool show)
 {
-    m_showFrameCount = show;
+    m_settings.update([show](Settings& settings) {
+        settings.showFrameCount = show;
+    });
 }
 
 void OverlayVideoPlugin::setShowResolution(bool show)
 {
-    m_showResolution = show;
+    m_settings.update([show](Settings& settings) {
+        settings.showResolution = show;
+    });
+}
+
+void OverlayVideoPlugin::setShowHealth(bool show)
+{
+    m_settings.update([show](Settings& settings) {
+        settings.showHealth = show;
+    });
 }
 
 void OverlayVideoPlugin::setTextColor(const QColor& color)
 {
-    m_textColor = color;
+    m_settings.update([&color](Settings& settings) {
+        settings.textColor = color;
+    });
 }
 
 void OverlayVideoPlugin::setBackgroundOpacity(double opacity)
 {
-    m_backgroundOpacity = qBound(0.0, opacity, 1.0);
+    opacity = qBound(0.0, opacity, 1.0);
+    m_settings.update([opacity](Settings& settings) {
+        settings.backgroundOpacity = opacity;
+    });
 }
 
-void OverlayVideoPlugin::drawOverlay(cv::Mat& frame, qint64 timestamp, qint64 frameIndex)
+void OverlayVideoPlugin::setVectorOverlay(bool vector)
 {
-    int yOffset = 30;
-    int lineHeight = 30;
-    int xPos = 10;
+    m_rasterOverlay = !vector;
+    m_settings.update([vector](Settings& settings) {
+        settings.vectorOverlay = vector;
+    });
+}
 
-    // Converter cor Qt para OpenCV
-    cv::Scalar cvColor(m_textColor.blue(), m_textColor.green(), m_textColor.red());
+QList<OverlayVideoPlugin::InfoLine> OverlayVideoPlugin::buildInfoLines(const Settings& settings, qint64 timestamp,
+                                                                       qint64 frameIndex) const
+{
+    QList<InfoLine> lines;
 
-    if (m_showFPS) {
-        QString fpsText = QString("FPS: %1 / %2").arg(m_currentFPS, 0, 'f', 1).arg(m_videoFps, 0, 'f', 1);
-        drawText(frame, fpsText, xPos, yOffset);
-        yOffset += lineHeight;
+    // FPS and health only change when refreshed (twice a second)
+    if (settings.showFPS) {
+        lines.append({QString("FPS: %1 / %2").arg(m_currentFPS, 0, 'f', 1).arg(m_videoFps, 0, 'f', 1), false});
     }
 
-    if (m_showTimestamp) {
-        QString timeText = QString("Time: %1").arg(formatTimestamp(timestamp));
-        drawText(frame, timeText, xPos, yOffset);
-        yOffset += lineHeight;
+    if (settings.showTimestamp) {
+        lines.append({QString("Time: %1").arg(formatTimestamp(timestamp)), true});
     }
 
-    if (m_showFrameCount) {
-        QString frameText = QString("Frame: %1").arg(frameIndex);
-        drawText(frame, frameText, xPos, yOffset);
-        yOffset += lineHeight;
+    if (settings.showFrameCount) {
+        lines.append({QString("Frame: %1").arg(frameIndex), true});
+    }
+
+    if (settings.showResolution) {
+        // The source size: in proxy mode the frame here is a smaller pyramid level
+        lines.append({QString("Resolution: %1x%2").arg(m_videoWidth).arg(m_videoHeight), false});
+    }
+
+    if (settings.showHealth) {
+        lines.append({QString("Decode: %1 fps  Plugins: %2 fps").arg(m_decodeFPS, 0, 'f', 1)
+                                                                .arg(m_pluginFPS, 0, 'f', 1), false});
+        lines.append({QString("Dropped: %1  Frame lag: %2 ms  A/V drift: %3 ms").arg(m_droppedFrames)
+                                                                                .arg(m_presentLagMs, 0, 'f', 0)
+                                                                                .arg(m_avDriftMs, 0, 'f', 0),
+                      false});
+        QString memory = QString("Memory: %1 MB, accounted %2 MB").arg(m_residentBytes / (1024 * 1024))
+                                                                   .arg(m_accountedBytes / (1024 * 1024));
+        if (m_memoryBudget > 0) {
+            memory += QString(" / %1 MB").arg(m_memoryBudget / (1024 * 1024));
+        }
+        lines.append({memory, false});
     }
 
-    if (m_showResolution) {
-        QString resText = QString("Resolution: %1x%2").arg(frame.cols).arg(frame.rows);
-        drawText(frame, resText, xPos, yOffset);
+    return lines;
+}
+
+void OverlayVideoPlugin::refreshHealth()
+{
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    registry.sampleProcess();
+    MetricsSnapshot snapshot = registry.snapshot();
+
+    // Frame counters are per view; memory is process-wide
+    const QString& scope = m_metricsScope;
+
+    // The first snapshot after a reset only establishes the baseline
+    if (m_lastSnapshot.timestampMs > 0) {
+        m_currentFPS = snapshot.rate(MetricNames::scoped(scope, MetricNames::FramesPresented), m_lastSnapshot);
+        m_decodeFPS = snapshot.rate(MetricNames::scoped(scope, MetricNames::FramesDecoded), m_lastSnapshot);
+        m_pluginFPS = snapshot.rate(MetricNames::scoped(scope, MetricNames::FramesProcessed), m_lastSnapshot);
+    }
+    m_droppedFrames = static_cast<qint64>(snapshot.value(MetricNames::scoped(scope, MetricNames::FramesDropped)));
+    m_presentLagMs = snapshot.value(MetricNames::scoped(scope, MetricNames::PresentLagMs));
+    m_avDriftMs = snapshot.value(MetricNames::scoped(scope, MetricNames::AvDriftMs));
+    m_residentBytes = static_cast<qint64>(snapshot.value(MetricNames::ResidentBytes));
+    m_accountedBytes = static_cast<qint64>(snapshot.value(MetricNames::MemoryTotal));
+    m_memoryBudget = static_cast<qint64>(snapshot.value(MetricNames::MemoryBudget));
+
+    m_lastSnapshot = std::move(snapshot);
+}
+
+void OverlayVideoPlugin::drawOverlay(cv::Mat& frame, const Settings& settings, qint64 timestamp, qint64 frameIndex)
+{
+    int yOffset = 30;
+    int lineHeight = 30;
+    int xPos = 10;
+
+    for (const InfoLine& line : buildInfoLines(settings, timestamp, frameIndex)) {
+        drawText(frame, settings, line.text, xPos, yOffset, line.perFrame);
         yOffset += lineHeight;
     }
 
     // Playback status
     if (m_isPlaying) {
-        drawText(frame, "PLAYING", frame.cols - 150, 30);
+        drawText(frame, settings, "PLAYING", frame.cols - 150, 30);
     } else {
-        drawText(frame, "PAUSED", frame.cols - 150, 30);
+        drawText(frame, settings, "PAUSED", frame.cols - 150, 30);
     }
 }
 
-void OverlayVideoPlugin::drawText(cv::Mat& frame, const QString& text, int x, int y)
+void OverlayVideoPlugin::drawText(cv::Mat& frame, const Settings& settings, const QString& text, int x, int y,
+                                  bool perFrame)
 {
-    std::string stdText = text.toStdString();
-    
-    // Converter cor Qt para OpenCV (BGR)
-    cv::Scalar textColor(m_textColor.blue(), m_textColor.green(), m_textColor.red());
-    cv::Scalar bgColor(0, 0, 0, m_backgroundOpacity * 255);
-    
     // Font settings
     int fontFace = cv::FONT_HERSHEY_SIMPLEX;
     double fontScale = 0.6;
     int thickness = 1;
-    int baseline = 0;
-    
-    // Calcular tamanho do texto
-    cv::Size textSize = cv::getTextSize(stdText, fontFace, fontScale, thickness, &baseline);
-    
-    // Desenhar fundo semi-transparente
-    int padding = 5;
-    cv::Rect bgRect(x - padding, y - textSize.height - padding,
-                    textSize.width + 2 * padding, textSize.height + 2 * padding);
-    
-    // Ensure rectangle is within frame bounds
-    bgRect.x = std::max(0, bgRect.x);
-    bgRect.y = std::max(0, bgRect.y);
-    bgRect.width = std::min(bgRect.width, frame.cols - bgRect.x);
-    bgRect.height = std::min(bgRect.height, frame.rows - bgRect.y);
-    
-    if (bgRect.width > 0 && bgRect.height > 0) {
-        // Draw semi-transparent background directly (optimized - no clone)
-        cv::Mat roi = frame(bgRect);
-        cv::Mat bg(bgRect.height, bgRect.width, frame.type(), cv::Scalar(0, 0, 0));
-        cv::addWeighted(roi, 1.0 - m_backgroundOpacity, bg, m_backgroundOpacity, 0, roi);
+
+    // Frames reach plugins in RGB order
+    cv::Vec3b textColor(settings.textColor.red(), settings.textColor.green(), settings.textColor.blue());
+
+    if (frame.type() != CV_8UC3) {
+        cv::putText(frame, text.toStdString(), cv::Point(x, y), fontFace, fontScale,
+                    cv::Scalar(textColor[0], textColor[1], textColor[2]), thickness, cv::LINE_AA);
+        return;
     }
-    
-    // Desenhar texto
-    cv::putText(frame, stdText, cv::Point(x, y), fontFace, fontScale, textColor, thickness, cv::LINE_AA);
+
+    if (perFrame) {
+        LabelBitmap label = LabelCache::render(text, fontFace, fontScale, thickness,
+                                               textColor, settings.backgroundOpacity);
+        LabelCache::composite(frame, label, cv::Point(x, y));
+        return;
+    }
+
+    // Rendered once per distinct label, then only blended into the frame
+    const LabelBitmap& label = m_labelCache.get(text, fontFace, fontScale, thickness,
+                                                textColor, settings.backgroundOpacity);
+    LabelCache::composite(frame, label, cv::Point(x, y));
 }
 
-QString OverlayVideoPlugin::formatTimestamp(qint64 timestampMs)
+QString OverlayVideoPlugin::formatTimestamp(qint64 timestampMs) const
 {
     int totalSeconds = timestampMs / 1000;
     int hours = totalSeconds / 3600;
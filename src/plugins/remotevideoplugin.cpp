@@ -0,0 +1,330 @@
+#include "plugins/remotevideoplugin.h"
+#include "core/logger.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QJsonDocument>
+#include <QProcess>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Slots in flight; a frame that timed out can't clobber the next one
+const uint32_t kSlotCount = 3;
+
+// Rows per copy band, large enough to amortize the task overhead
+const int kCopyBandRows = 64;
+
+const int kFrameTimeoutMs = 250;
+const int kCommandTimeoutMs = 1000;
+const int kStartupTimeoutMs = 10000; // Includes loading the plugin library
+
+// Fallback slot size when the video size is unknown (4K RGBA)
+const size_t kDefaultSlotBytes = 3840 * 2160 * 4;
+
+/**
+ * @brief Copies a frame in row bands; one thread can't saturate memory bandwidth
+ */
+void copyFrame(const cv::Mat& source, cv::Mat& target)
+{
+    const int bands = (source.rows + kCopyBandRows - 1) / kCopyBandRows;
+    const size_t rowBytes = source.cols * source.elemSize();
+    cv::parallel_for_(cv::Range(0, bands), [&](const cv::Range& range) {
+        int y0 = range.start * kCopyBandRows;
+        int y1 = std::min(source.rows, range.end * kCopyBandRows);
+        if (source.isContinuous() && target.isContinuous()) {
+            std::memcpy(target.ptr(y0), source.ptr(y0), rowBytes * (y1 - y0));
+            return;
+        }
+        for (int y = y0; y < y1; ++y) {
+            std::memcpy(target.ptr(y), source.ptr(y), rowBytes);
+        }
+    });
+}
+
+} // namespace
+
+RemoteVideoPlugin::RemoteVideoPlugin(const QString& libraryPath, const QVariantMap& metadata)
+    : m_libraryPath(libraryPath)
+    , m_metadata(metadata)
+    , m_enabled(false)
+    , m_hostFailed(true)
+    , m_nextSlot(0)
+    , m_ringCharge(MemorySubsystem::FramePools)
+{
+}
+
+RemoteVideoPlugin::~RemoteVideoPlugin()
+{
+    stopHost();
+}
+
+bool RemoteVideoPlugin::processFrame(cv::Mat& frame, qint64 timestamp, qint64 frameIndex)
+{
+    if (!m_enabled || m_hostFailed || frame.empty()) {
+        return false;
+    }
+
+    QMutexLocker locker(&m_channelMutex);
+    if (!m_ring.isOpen()) {
+        return false;
+    }
+
+    const size_t bytes = frame.total() * frame.elemSize();
+    if (bytes > m_ring.slotBytes()) {
+        LOG_WARNING("RemoteVideoPlugin", "Frame larger than the shared slot: %1", getName());
+        return false;
+    }
+
+    uint32_t slotIndex = m_nextSlot;
+    m_nextSlot = (m_nextSlot + 1) % m_ring.slotCount();
+
+    // The only copy on the way in; the host works on the slot directly
+    cv::Mat shared(frame.rows, frame.cols, frame.type(), m_ring.slot(slotIndex));
+    copyFrame(frame, shared);
+
+    SharedFrameHeader* header = m_ring.header();
+    header->kind = SharedFrameHeader::Frame;
+    header->slot = static_cast<int32_t>(slotIndex);
+    header->rows = frame.rows;
+    header->cols = frame.cols;
+    header->type = frame.type();
+    header->step = shared.step;
+    header->timestamp = timestamp;
+    header->frameIndex = frameIndex;
+    header->status = 0;
+    header->modified = 0;
+
+    uint32_t sequence = m_ring.postRequest();
+    if (!m_ring.waitResponse(sequence, kFrameTimeoutMs)) {
+        markFailed("frame timed out");
+        return false;
+    }
+
+    if (header->status != 1) {
+        return false;
+    }
+
+    // Readers never write, so their frame is already up to date
+    if (header->modified && frameAccess() == FrameAccess::ReadWrite) {
+        copyFrame(shared, frame);
+    }
+    return true;
+}
+
+void RemoteVideoPlugin::initialize(const QVariantMap& videoInfo)
+{
+    // A new video (or a retry after a crash) gets a fresh host
+    stopHost();
+
+    int width = videoInfo.value("width", 0).toInt();
+    int height = videoInfo.value("height", 0).toInt();
+    size_t slotBytes = width > 0 && height > 0 ? static_cast<size_t>(width) * height * 4
+                                               : kDefaultSlotBytes;
+
+    if (!startHost(slotBytes)) {
+        qWarning() << "[RemoteVideoPlugin] Host did not start for" << getName();
+        return;
+    }
+
+    QJsonObject command;
+    command["command"] = "initialize";
+    command["videoInfo"] = QJsonObject::fromVariantMap(videoInfo);
+    if (!sendCommand(command, kStartupTimeoutMs)) {
+        qWarning() << "[RemoteVideoPlugin] Host failed to initialize" << getName();
+        stopHost();
+        return;
+    }
+
+    m_hostFailed = false;
+
+    if (!m_settings.isEmpty()) {
+        setSettings(m_settings);
+    }
+
+    qDebug() << "[RemoteVideoPlugin] Host running for" << getName();
+}
+
+void RemoteVideoPlugin::finalize()
+{
+    QJsonObject command;
+    command["command"] = "finalize";
+    sendCommand(command, kCommandTimeoutMs);
+    stopHost();
+}
+
+void RemoteVideoPlugin::onPlaybackStarted()
+{
+    QJsonObject command;
+    command["command"] = "playbackStarted";
+    sendCommand(command, kCommandTimeoutMs);
+}
+
+void RemoteVideoPlugin::onPlaybackPaused()
+{
+    QJsonObject command;
+    command["command"] = "playbackPaused";
+    sendCommand(command, kCommandTimeoutMs);
+}
+
+void RemoteVideoPlugin::onPlaybackStopped()
+{
+    QJsonObject command;
+    command["command"] = "playbackStopped";
+    sendCommand(command, kCommandTimeoutMs);
+}
+
+void RemoteVideoPlugin::onSeek(qint64 position)
+{
+    QJsonObject command;
+    command["command"] = "seek";
+    command["position"] = position;
+    sendCommand(command, kCommandTimeoutMs);
+}
+
+QString RemoteVideoPlugin::getName() const
+{
+    return m_metadata.value("name").toString();
+}
+
+QString RemoteVideoPlugin::getVersion() const
+{
+    return m_metadata.value("version").toString();
+}
+
+QString RemoteVideoPlugin::getDescription() const
+{
+    return m_metadata.value("description").toString() + " (isolated)";
+}
+
+bool RemoteVideoPlugin::isEnabled() const
+{
+    return m_enabled;
+}
+
+void RemoteVideoPlugin::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+}
+
+void RemoteVideoPlugin::setSettings(const QVariantMap& settings)
+{
+    m_settings = settings;
+
+    QJsonObject command;
+    command["command"] = "setSettings";
+    command["settings"] = QJsonObject::fromVariantMap(settings);
+    sendCommand(command, kCommandTimeoutMs);
+}
+
+QVariantMap RemoteVideoPlugin::getSettings() const
+{
+    return m_settings;
+}
+
+int RemoteVideoPlugin::getPriority() const
+{
+    return m_metadata.value("priority", 100).toInt();
+}
+
+bool RemoteVideoPlugin::isVisualPlugin() const
+{
+    return m_metadata.value("visual", false).toBool();
+}
+
+IVideoPlugin::FrameAccess RemoteVideoPlugin::frameAccess() const
+{
+    return m_metadata.value("readOnly", false).toBool() ? FrameAccess::ReadOnly
+                                                        : FrameAccess::ReadWrite;
+}
+
+bool RemoteVideoPlugin::isHostAlive() const
+{
+    return !m_hostFailed;
+}
+
+bool RemoteVideoPlugin::startHost(size_t slotBytes)
+{
+    QMutexLocker locker(&m_channelMutex);
+
+    if (!m_ring.create(SharedFrameRing::uniqueName(), slotBytes, kSlotCount)) {
+        qWarning() << "[RemoteVideoPlugin] Failed to create shared frame ring";
+        return false;
+    }
+    m_nextSlot = 0;
+    m_ringCharge.set(static_cast<qint64>(m_ring.slotBytes()) * m_ring.slotCount());
+
+    m_process = std::make_unique<QProcess>();
+    m_process->setProcessChannelMode(QProcess::ForwardedChannels);
+    m_process->start(QCoreApplication::applicationDirPath() + "/blazestudio_pluginhost",
+                     {"--ring", QString::fromStdString(m_ring.name()), "--plugin", m_libraryPath,
+                      "--viewer-pid", QString::number(QCoreApplication::applicationPid())});
+    if (!m_process->waitForStarted(kCommandTimeoutMs)) {
+        qWarning() << "[RemoteVideoPlugin] Failed to start plugin host:" << m_process->errorString();
+        m_process.reset();
+        m_ring.close();
+        m_ringCharge.set(0);
+        return false;
+    }
+    return true;
+}
+
+void RemoteVideoPlugin::stopHost()
+{
+    if (m_process) {
+        {
+            QMutexLocker locker(&m_channelMutex);
+            if (m_ring.isOpen() && !m_hostFailed) {
+                m_ring.header()->kind = SharedFrameHeader::Shutdown;
+                m_ring.waitResponse(m_ring.postRequest(), kCommandTimeoutMs);
+            }
+        }
+        if (!m_process->waitForFinished(kCommandTimeoutMs)) {
+            m_process->kill();
+            m_process->waitForFinished(kCommandTimeoutMs);
+        }
+        m_process.reset();
+    }
+
+    QMutexLocker locker(&m_channelMutex);
+    m_ring.close();
+    m_ringCharge.set(0);
+    m_hostFailed = true;
+}
+
+bool RemoteVideoPlugin::sendCommand(const QJsonObject& command, int timeoutMs)
+{
+    QMutexLocker locker(&m_channelMutex);
+    if (!m_ring.isOpen() || (m_hostFailed && command.value("command") != "initialize")) {
+        return false;
+    }
+
+    QByteArray payload = QJsonDocument(command).toJson(QJsonDocument::Compact);
+    if (payload.size() > static_cast<int>(SharedFrameHeader::kPayloadCapacity)) {
+        qWarning() << "[RemoteVideoPlugin] Command too large:" << command.value("command").toString();
+        return false;
+    }
+
+    SharedFrameHeader* header = m_ring.header();
+    header->kind = SharedFrameHeader::Command;
+    header->status = 0;
+    header->payloadBytes = static_cast<uint32_t>(payload.size());
+    std::memcpy(header->payload, payload.constData(), payload.size());
+
+    uint32_t sequence = m_ring.postRequest();
+    if (!m_ring.waitResponse(sequence, timeoutMs)) {
+        locker.unlock();
+        markFailed("command timed out");
+        return false;
+    }
+    return header->status == 1;
+}
+
+void RemoteVideoPlugin::markFailed(const char* reason)
+{
+    // Process handling stays on the thread that owns it; the next
+    // initialize() restarts the host
+    if (!m_hostFailed.exchange(true)) {
+        qWarning() << "[RemoteVideoPlugin]" << getName() << "host failed:" << reason;
+    }
+}
@@ -1,17 +1,25 @@
 #include "ui/mainwindow.h"
 #include "./ui_mainwindow.h"
 #include "widgets/videoglwidget.h"
+#include "widgets/multiviewwidget.h"
+#include "ui/pluginmanagerwindow.h"
 #include "plugins/overlayvideoplugin.h"
+#include "core/tracing.h"
+#include <QCoreApplication>
 #include <QMessageBox>
 #include <QDebug>
 #include <QFile>
 #include <QFileDialog>
+#include <QInputDialog>
+#include <QStatusBar>
 #include <memory>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
     , videoWidget(nullptr)
+    , pluginManagerWindow(nullptr)
+    , multiViewWidget(nullptr)
 {
     ui->setupUi(this);
 
@@ -19,7 +27,12 @@ MainWindow::MainWindow(QWidget *parent)
     videoWidget = ui->openGLWidget;
 
     // Setup plugin system
-    setupPlugins();
+    setupPlugins(videoWidget);
+
+    connect(videoWidget, &VideoGLWidget::rawCaptureFinished, this,
+            [this](const QString& path, qint64 frames) {
+                statusBar()->showMessage(QString("Captured %1 raw frames to %2").arg(frames).arg(path), 5000);
+            });
 
     // // Try to load video automatically
     // QString videoPath = "video.mp4";
@@ -54,19 +67,22 @@ MainWindow::~MainWindow()
     delete ui;
 }
 
-void MainWindow::setupPlugins()
+void MainWindow::setupPlugins(VideoGLWidget* widget)
 {
-    if (!videoWidget) {
+    if (!widget) {
         return;
     }
 
     // Get plugin manager
-    VideoPluginManager* pluginManager = videoWidget->pluginManager();
+    VideoPluginManager* pluginManager = widget->pluginManager();
     if (!pluginManager) {
         qWarning() << "Plugin manager not available";
         return;
     }
 
+    // Interactive review only needs display resolution
+    pluginManager->setProxyEnabled(true);
+
     // Create and add overlay plugin
     auto overlayPlugin = std::make_shared<OverlayVideoPlugin>();
     
@@ -80,6 +96,9 @@ void MainWindow::setupPlugins()
     
     // Add to manager
     pluginManager->addPlugin(overlayPlugin);
+
+    // Optional plugins ship as libraries and are only loaded when enabled
+    pluginManager->discoverPlugins(QCoreApplication::applicationDirPath() + "/plugins");
     
     qDebug() << "Plugins configured successfully!";
     qDebug() << "Total de plugins:" << pluginManager->getPluginCount();
@@ -121,6 +140,148 @@ void MainWindow::on_actionOpen_triggered()
 }
 
 
+void MainWindow::on_actionOpenMultiView_triggered()
+{
+    QString filter = "Video Files (*.mp4 *.avi *.mkv *.mov *.wmv *.flv *.webm *.m4v);;";
+    filter += "All files (*.*)";
+
+    QStringList videoPaths = QFileDialog::getOpenFileNames(
+        this,
+        QString("Open Angles (up to %1)").arg(MultiViewWidget::MaxViews),
+        QDir::homePath(),
+        filter
+    );
+    if (videoPaths.isEmpty()) {
+        return;
+    }
+    if (videoPaths.size() > MultiViewWidget::MaxViews) {
+        QMessageBox::information(this, "Multi-View",
+            QString("Only the first %1 videos will be shown.").arg(MultiViewWidget::MaxViews));
+    }
+
+    if (!multiViewWidget) {
+        multiViewWidget = new MultiViewWidget(this);
+        multiViewWidget->setWindowFlag(Qt::Window);
+        multiViewWidget->resize(1280, 800);
+
+        // Every angle gets its own plugin chain
+        connect(multiViewWidget, &MultiViewWidget::viewCreated, this, &MainWindow::setupPlugins);
+        connect(multiViewWidget, &MultiViewWidget::pluginManagerRequested, this,
+                [this](VideoGLWidget* view) {
+                    auto* window = new PluginManagerWindow(view, multiViewWidget);
+                    window->setAttribute(Qt::WA_DeleteOnClose);
+                    // The view is replaced on the next load; its window goes with it
+                    connect(view, &QObject::destroyed, window, &QWidget::close);
+                    window->show();
+                });
+    }
+
+    // One decoder per angle is enough load; don't keep the main view running too
+    if (videoWidget && videoWidget->isPlaying()) {
+        videoWidget->pause();
+    }
+
+    multiViewWidget->show();
+    multiViewWidget->raise();
+    if (multiViewWidget->loadVideos(videoPaths)) {
+        multiViewWidget->play();
+    } else {
+        QMessageBox::warning(this, "Error", "Could not open every video of the session.");
+    }
+}
+
+
+void MainWindow::on_actionPluginManager_triggered()
+{
+    // Modeless, so latency can be watched while the video plays
+    if (!pluginManagerWindow) {
+        pluginManagerWindow = new PluginManagerWindow(videoWidget, this);
+    }
+    pluginManagerWindow->show();
+    pluginManagerWindow->raise();
+    pluginManagerWindow->activateWindow();
+}
+
+
+void MainWindow::on_actionCaptureRawFrames_triggered()
+{
+    if (videoWidget->isRawCapturing()) {
+        videoWidget->stopRawCapture();
+        return;
+    }
+
+    QString capturePath = QFileDialog::getSaveFileName(
+        this,
+        "Capture Raw Frames",
+        QDir::homePath() + "/capture.bsraw",
+        "Raw Frames (*.bsraw)"
+    );
+    if (capturePath.isEmpty()) {
+        return;
+    }
+
+    bool ok = false;
+    int frames = QInputDialog::getInt(this, "Capture Raw Frames", "Number of frames:", 300, 1, 100000, 1, &ok);
+    if (!ok) {
+        return;
+    }
+
+    // Frames are taken from playback; start it if needed
+    if (!videoWidget->startRawCapture(capturePath, frames)) {
+        QMessageBox::warning(this, "Error",
+            QString("Could not create capture file:\n%1").arg(capturePath));
+        return;
+    }
+    if (!videoWidget->isPlaying()) {
+        videoWidget->play();
+    }
+}
+
+
+void MainWindow::on_actionRecordTrace_toggled(bool checked)
+{
+    if (checked) {
+        Tracer::start();
+        return;
+    }
+
+    Tracer::stop();
+
+    QString tracePath = QFileDialog::getSaveFileName(
+        this,
+        "Save Pipeline Trace",
+        QDir::homePath() + "/blazestudio-trace.json",
+        "Chrome Trace (*.json)"
+    );
+    if (tracePath.isEmpty()) {
+        return;
+    }
+
+    if (!Tracer::writeChromeTrace(tracePath)) {
+        QMessageBox::warning(this, "Error",
+            QString("Could not write trace:\n%1").arg(tracePath));
+    } else if (Tracer::droppedEvents() > 0) {
+        statusBar()->showMessage(QString("Trace saved, %1 events dropped (buffers full)")
+                                     .arg(Tracer::droppedEvents()), 5000);
+    } else {
+        statusBar()->showMessage("Trace saved: open it in ui.perfetto.dev or chrome://tracing", 5000);
+    }
+}
+
+void MainWindow::on_actionShowHealth_toggled(bool checked)
+{
+    if (!videoWidget || !videoWidget->pluginManager()) {
+        return;
+    }
+
+    auto overlayPlugin = std::dynamic_pointer_cast<OverlayVideoPlugin>(
+        videoWidget->pluginManager()->getPlugin("Overlay Plugin"));
+    if (overlayPlugin) {
+        overlayPlugin->setShowHealth(checked);
+    }
+}
+
+
 void MainWindow::on_play_btn_clicked()
 {
     if (videoWidget) {
@@ -157,6 +318,26 @@ void MainWindow::on_add_1_clicked()
 }
 
 
+void MainWindow::on_speed_combo_currentIndexChanged(int index)
+{
+    // Items read "0.25x", "2x", ...
+    QString text = ui->speed_combo->itemText(index);
+    bool ok = false;
+    double rate = text.left(text.size() - 1).toDouble(&ok);
+    if (videoWidget && ok) {
+        videoWidget->setPlaybackRate(rate);
+    }
+}
+
+
+void MainWindow::on_interpolate_chk_toggled(bool checked)
+{
+    if (videoWidget) {
+        videoWidget->setSlowMotionInterpolation(checked);
+    }
+}
+
+
 void MainWindow::on_minus_01_clicked()
 {
     if (videoWidget) {
@@ -1,14 +1,196 @@
 #include "ui/pluginmanagerwindow.h"
 #include "ui_pluginmanagerwindow.h"
+#include "widgets/videoglwidget.h"
+#include <QHeaderView>
+#include <QSignalBlocker>
+#include <QTimer>
 
-PluginManagerWindow::PluginManagerWindow(QWidget *parent)
+namespace {
+
+// Latency view refresh period while the dialog is visible
+const int kRefreshIntervalMs = 500;
+
+const QColor kOverBudgetColor(255, 205, 205);
+
+} // namespace
+
+PluginManagerWindow::PluginManagerWindow(VideoGLWidget *videoWidget, QWidget *parent)
     : QDialog(parent)
     , ui(new Ui::PluginManagerWindow)
+    , m_videoWidget(videoWidget)
+    , m_refreshTimer(new QTimer(this))
 {
     ui->setupUi(this);
+
+    ui->latencyTable->setColumnCount(6);
+    ui->latencyTable->setHorizontalHeaderLabels(
+        {"Stage", "Calls", "p50 (ms)", "p95 (ms)", "p99 (ms)", "Max (ms)"});
+    ui->latencyTable->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    connect(ui->pluginsList, &QListWidget::itemChanged,
+            this, &PluginManagerWindow::onPluginItemChanged);
+
+    m_refreshTimer->setInterval(kRefreshIntervalMs);
+    connect(m_refreshTimer, &QTimer::timeout, this, &PluginManagerWindow::refreshLatency);
+
+    // Queued: the list is rebuilt while one of its items may still be emitting itemChanged
+    if (VideoPluginManager* manager = m_videoWidget ? m_videoWidget->pluginManager() : nullptr) {
+        connect(manager, &VideoPluginManager::pluginAdded,
+                this, &PluginManagerWindow::refreshPlugins, Qt::QueuedConnection);
+        connect(manager, &VideoPluginManager::pluginRemoved,
+                this, &PluginManagerWindow::refreshPlugins, Qt::QueuedConnection);
+        connect(manager, &VideoPluginManager::pluginStateChanged,
+                this, &PluginManagerWindow::refreshPlugins, Qt::QueuedConnection);
+    }
+
+    refreshPlugins();
+    refreshLatency();
 }
 
 PluginManagerWindow::~PluginManagerWindow()
 {
     delete ui;
 }
+
+void PluginManagerWindow::showEvent(QShowEvent *event)
+{
+    QDialog::showEvent(event);
+    refreshPlugins();
+    refreshLatency();
+    m_refreshTimer->start();
+}
+
+void PluginManagerWindow::hideEvent(QHideEvent *event)
+{
+    // Nothing to look at, don't poll the histograms
+    m_refreshTimer->stop();
+    QDialog::hideEvent(event);
+}
+
+void PluginManagerWindow::refreshPlugins()
+{
+    VideoPluginManager* manager = m_videoWidget ? m_videoWidget->pluginManager() : nullptr;
+    if (!manager) {
+        return;
+    }
+
+    // Rebuilding the items must not be mistaken for user toggles
+    QSignalBlocker blocker(ui->pluginsList);
+    ui->pluginsList->clear();
+
+    const QStringList names = manager->getAvailablePlugins();
+    for (const QString& name : names) {
+        auto plugin = manager->getPlugin(name);
+        QVariantMap metadata = manager->getPluginMetadata(name);
+
+        QString version = plugin ? plugin->getVersion() : metadata.value("version").toString();
+        QString description = plugin ? plugin->getDescription() : metadata.value("description").toString();
+
+        auto* item = new QListWidgetItem(QString("%1 %2").arg(name, version), ui->pluginsList);
+        item->setData(Qt::UserRole, name);
+        item->setToolTip(plugin ? description : description + "\n(not loaded)");
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(plugin && plugin->isEnabled() ? Qt::Checked : Qt::Unchecked);
+    }
+}
+
+void PluginManagerWindow::refreshLatency()
+{
+    if (!m_videoWidget || !m_videoWidget->pluginManager()) {
+        return;
+    }
+
+    VideoPluginManager* manager = m_videoWidget->pluginManager();
+
+    double fps = m_videoWidget->getFps();
+    double budgetMs = fps > 0.0 ? 1000.0 / fps : 0.0;
+    QString label = budgetMs > 0.0
+        ? QString("Latency (frame budget %1 ms)").arg(budgetMs, 0, 'f', 1)
+        : QString("Latency");
+    label += QString(" - frame clones: %1 in %2 frames")
+        .arg(manager->getCloneCount()).arg(manager->getProcessedFrameCount());
+    ui->budgetLabel->setText(label);
+
+    // Vsync pacing of the view, collected since playback started
+    const PresentationStats presentation = m_videoWidget->presentationStats();
+    ui->presentationLabel->setText(
+        QString("Presentation: swap interval %1 ms, jitter %2 ms, max %3 ms - "
+                "%4 frames shown, %5 swaps repeated, %6 frames skipped - "
+                "PTS error mean %7 ms, max %8 ms")
+            .arg(presentation.meanSwapIntervalMs, 0, 'f', 2)
+            .arg(presentation.swapJitterMs, 0, 'f', 2)
+            .arg(presentation.maxSwapIntervalMs, 0, 'f', 1)
+            .arg(presentation.presentedFrames)
+            .arg(presentation.repeatedVsyncs)
+            .arg(presentation.skippedFrames)
+            .arg(presentation.meanAbsPtsErrorMs, 0, 'f', 1)
+            .arg(presentation.maxAbsPtsErrorMs, 0, 'f', 1));
+
+    const auto stages = m_videoWidget->pipelineLatencies();
+    const auto plugins = m_videoWidget->pluginManager()->getPluginLatencies();
+
+    ui->latencyTable->setRowCount(stages.size() + plugins.size());
+
+    int row = 0;
+    for (const auto& stage : stages) {
+        setLatencyRow(row++, stage.first, stage.second, budgetMs);
+    }
+    for (const auto& plugin : plugins) {
+        QString name = plugin.enabled ? plugin.name : plugin.name + " (disabled)";
+        if (plugin.enabled && !plugin.status.isEmpty()) {
+            name += " - " + plugin.status;
+        }
+        setLatencyRow(row++, "  " + name, plugin.stats, budgetMs);
+    }
+}
+
+void PluginManagerWindow::onPluginItemChanged(QListWidgetItem *item)
+{
+    VideoPluginManager* manager = m_videoWidget ? m_videoWidget->pluginManager() : nullptr;
+    if (!manager || !item) {
+        return;
+    }
+
+    QString name = item->data(Qt::UserRole).toString();
+    bool enabled = item->checkState() == Qt::Checked;
+
+    // May load the plugin library; the list is refreshed from pluginStateChanged
+    if (!manager->setPluginEnabled(name, enabled)) {
+        QSignalBlocker blocker(ui->pluginsList);
+        item->setCheckState(enabled ? Qt::Unchecked : Qt::Checked);
+    }
+}
+
+void PluginManagerWindow::on_resetButton_clicked()
+{
+    if (m_videoWidget) {
+        m_videoWidget->resetLatencyStats();
+    }
+    refreshLatency();
+}
+
+void PluginManagerWindow::setLatencyRow(int row, const QString& name, const LatencyStats& stats, double budgetMs)
+{
+    const QStringList values = {
+        name,
+        QString::number(stats.count),
+        QString::number(stats.p50Ms, 'f', 2),
+        QString::number(stats.p95Ms, 'f', 2),
+        QString::number(stats.p99Ms, 'f', 2),
+        QString::number(stats.maxMs, 'f', 2)
+    };
+
+    bool overBudget = budgetMs > 0.0 && stats.p95Ms > budgetMs;
+
+    for (int column = 0; column < values.size(); ++column) {
+        QTableWidgetItem* item = ui->latencyTable->item(row, column);
+        if (!item) {
+            item = new QTableWidgetItem();
+            ui->latencyTable->setItem(row, column, item);
+        }
+        item->setText(values[column]);
+        item->setTextAlignment(column == 0 ? (Qt::AlignLeft | Qt::AlignVCenter)
+                                           : (Qt::AlignRight | Qt::AlignVCenter));
+        item->setBackground(overBudget ? QBrush(kOverBudgetColor) : QBrush());
+    }
+}
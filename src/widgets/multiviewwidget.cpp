@@ -0,0 +1,300 @@
+#include "widgets/multiviewwidget.h"
+#include "widgets/videoglwidget.h"
+#include <QCloseEvent>
+#include <QDebug>
+#include <QFileInfo>
+#include <QGridLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QScreen>
+#include <QSignalBlocker>
+#include <QSpinBox>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+// Recordings started by hand are rarely more than a few minutes apart
+const int kMaxOffsetMs = 10 * 60 * 1000;
+const int kOffsetStepMs = 10;
+
+const qint64 kStepMs = 1000;
+
+} // namespace
+
+MultiViewWidget::MultiViewWidget(QWidget *parent)
+    : QWidget(parent)
+    , m_grid(new QGridLayout)
+    , m_isPlaying(false)
+{
+    setWindowTitle("Multi-View");
+
+    auto* layout = new QVBoxLayout(this);
+    layout->addLayout(m_grid, 1);
+
+    auto* controls = new QHBoxLayout;
+    auto* backButton = new QPushButton("-1s", this);
+    auto* playButton = new QPushButton("Play", this);
+    auto* pauseButton = new QPushButton("Pause", this);
+    auto* forwardButton = new QPushButton("+1s", this);
+    controls->addWidget(backButton);
+    controls->addWidget(playButton);
+    controls->addWidget(pauseButton);
+    controls->addWidget(forwardButton);
+    controls->addStretch();
+    layout->addLayout(controls);
+
+    connect(playButton, &QPushButton::clicked, this, &MultiViewWidget::play);
+    connect(pauseButton, &QPushButton::clicked, this, &MultiViewWidget::pause);
+    connect(backButton, &QPushButton::clicked, this, [this]() {
+        pause();
+        seek(position() - kStepMs);
+    });
+    connect(forwardButton, &QPushButton::clicked, this, [this]() {
+        pause();
+        seek(position() + kStepMs);
+    });
+}
+
+MultiViewWidget::~MultiViewWidget()
+{
+    // Views read the clock, which is destroyed before the child widgets
+    pause();
+    clearViews();
+}
+
+bool MultiViewWidget::loadVideos(const QStringList& videoPaths)
+{
+    pause();
+    clearViews();
+
+    const int count = std::min<int>(videoPaths.size(), MaxViews);
+    if (videoPaths.size() > MaxViews) {
+        qWarning() << "[MultiViewWidget] Only the first" << MaxViews << "videos are shown";
+    }
+    const int columns = count > 1 ? 2 : 1;
+
+    for (int i = 0; i < count; ++i) {
+        const QString& path = videoPaths[i];
+
+        auto* cell = new QWidget(this);
+        auto* cellLayout = new QVBoxLayout(cell);
+        cellLayout->setContentsMargins(0, 0, 0, 0);
+
+        auto* view = new VideoGLWidget(cell);
+        view->setSharedClock(&m_clock);
+        view->setAudioEnabled(i == 0);
+        view->setMetricsScope(QString("grid%1").arg(i));
+        cellLayout->addWidget(view, 1);
+
+        auto* offsetSpin = new QSpinBox(cell);
+        offsetSpin->setRange(-kMaxOffsetMs, kMaxOffsetMs);
+        offsetSpin->setSingleStep(kOffsetStepMs);
+        offsetSpin->setSuffix(" ms");
+        offsetSpin->setToolTip("Shift this angle: it shows its video at session time + offset");
+
+        auto* pluginsButton = new QPushButton("Plugins...", cell);
+
+        auto* bar = new QHBoxLayout;
+        bar->addWidget(new QLabel(QFileInfo(path).fileName(), cell), 1);
+        bar->addWidget(new QLabel("Offset", cell));
+        bar->addWidget(offsetSpin);
+        bar->addWidget(pluginsButton);
+        cellLayout->addLayout(bar);
+
+        m_grid->addWidget(cell, i / columns, i % columns);
+        m_cells.push_back(cell);
+        m_views.push_back(view);
+        m_offsetSpins.push_back(offsetSpin);
+
+        connect(offsetSpin, &QSpinBox::valueChanged, this, [this, i](int value) {
+            setTimeOffset(i, value);
+        });
+        connect(pluginsButton, &QPushButton::clicked, this, [this, view]() {
+            emit pluginManagerRequested(view);
+        });
+
+        // Plugins must be in place before loadVideo initializes them
+        emit viewCreated(view);
+
+        if (!view->loadVideo(path)) {
+            qWarning() << "[MultiViewWidget] Failed to open" << path;
+            clearViews();
+            return false;
+        }
+    }
+
+    if (m_views.empty()) {
+        return false;
+    }
+
+    // The first view paces the whole grid, from its swaps or its timer while hidden
+    connect(m_views.front(), &VideoGLWidget::presentationDue, this, &MultiViewWidget::onLeaderPresentationDue);
+
+    m_clock.pause();
+    seek(0);
+
+    qDebug() << "[MultiViewWidget] Loaded" << m_views.size() << "views,"
+             << m_decodePool.maxThreadCount() << "decode threads";
+    return true;
+}
+
+void MultiViewWidget::play()
+{
+    if (m_views.empty() || m_isPlaying) {
+        return;
+    }
+
+    qDebug() << "[MultiViewWidget] Starting playback";
+    m_isPlaying = true;
+
+    for (VideoGLWidget* view : m_views) {
+        view->play();
+    }
+
+    // Audio, when there is any, only comes from the first view
+    m_clock.setSource(m_views.front()->isAudible() ? MediaClock::Source::Audio
+                                                   : MediaClock::Source::FreeRun);
+    m_clock.start(m_clock.nowMs());
+
+    QScreen* currentScreen = screen();
+    m_scheduler.reset(currentScreen ? currentScreen->refreshRate() : 60.0);
+    for (VideoGLWidget* view : m_views) {
+        view->update();
+    }
+}
+
+void MultiViewWidget::pause()
+{
+    if (!m_isPlaying) {
+        return;
+    }
+
+    qDebug() << "[MultiViewWidget] Pausing playback";
+    m_isPlaying = false;
+    m_clock.pause();
+
+    for (VideoGLWidget* view : m_views) {
+        view->pause();
+    }
+}
+
+void MultiViewWidget::seek(qint64 positionMs)
+{
+    positionMs = std::max<qint64>(0, positionMs);
+    m_clock.seek(positionMs);
+
+    for (VideoGLWidget* view : m_views) {
+        view->seek(std::max<qint64>(0, positionMs + view->timeOffset()));
+    }
+}
+
+bool MultiViewWidget::isPlaying() const
+{
+    return m_isPlaying;
+}
+
+qint64 MultiViewWidget::position() const
+{
+    return static_cast<qint64>(m_clock.nowMs());
+}
+
+void MultiViewWidget::setTimeOffset(int viewIndex, qint64 offsetMs)
+{
+    if (viewIndex < 0 || viewIndex >= viewCount()) {
+        return;
+    }
+
+    VideoGLWidget* target = m_views[viewIndex];
+    if (target->timeOffset() == offsetMs) {
+        return;
+    }
+    target->setTimeOffset(offsetMs);
+
+    QSignalBlocker blocker(m_offsetSpins[viewIndex]);
+    m_offsetSpins[viewIndex]->setValue(static_cast<int>(offsetMs));
+
+    // Realign now; otherwise a view moved back would hold its frame until caught up
+    target->seek(std::max<qint64>(0, position() + offsetMs));
+}
+
+qint64 MultiViewWidget::timeOffset(int viewIndex) const
+{
+    if (viewIndex < 0 || viewIndex >= viewCount()) {
+        return 0;
+    }
+    return m_views[viewIndex]->timeOffset();
+}
+
+int MultiViewWidget::viewCount() const
+{
+    return static_cast<int>(m_views.size());
+}
+
+VideoGLWidget* MultiViewWidget::view(int viewIndex) const
+{
+    if (viewIndex < 0 || viewIndex >= viewCount()) {
+        return nullptr;
+    }
+    return m_views[viewIndex];
+}
+
+void MultiViewWidget::closeEvent(QCloseEvent* event)
+{
+    pause();
+    QWidget::closeEvent(event);
+}
+
+void MultiViewWidget::onLeaderPresentationDue()
+{
+    if (!m_isPlaying || m_views.empty()) {
+        return;
+    }
+
+    // The first view's stream runs ahead of the session by its offset
+    VideoGLWidget* leader = m_views.front();
+    m_clock.updateAudio(leader->audioPosition() - leader->timeOffset());
+
+    m_scheduler.onVsync();
+    const double displayTime = m_scheduler.displayTimeMs(m_clock.nowMs(), m_clock.rate());
+
+    // Each view only touches its own decoder, so the streams decode in parallel
+    std::vector<char> active(m_views.size(), 0);
+    std::vector<std::function<void()>> jobs;
+    jobs.reserve(m_views.size());
+    for (size_t i = 0; i < m_views.size(); ++i) {
+        VideoGLWidget* view = m_views[i];
+        char* viewActive = &active[i];
+        jobs.emplace_back([view, viewActive, displayTime]() {
+            *viewActive = view->decodeForClock(displayTime);
+        });
+    }
+    m_decodePool.runAll(jobs);
+
+    // Plugins and texture uploads stay on the UI thread
+    for (VideoGLWidget* view : m_views) {
+        view->presentDecoded();
+    }
+
+    if (std::none_of(active.begin(), active.end(), [](char viewActive) { return viewActive != 0; })) {
+        qDebug() << "[MultiViewWidget] End of all videos reached";
+        pause();
+        return;
+    }
+
+    for (VideoGLWidget* view : m_views) {
+        view->update();
+    }
+}
+
+void MultiViewWidget::clearViews()
+{
+    for (QWidget* cell : m_cells) {
+        delete cell;
+    }
+    m_cells.clear();
+    m_views.clear();
+    m_offsetSpins.clear();
+}
@@ -1,22 +1,209 @@
 #include "widgets/videoglwidget.h"
+#include "core/logger.h"
+#include "core/rawframefile.h"
+#include "core/tracing.h"
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QFontMetricsF>
+#include <QMediaDevices>
+#include <QPainter>
+#include <QScreen>
 #include <QSurfaceFormat>
+#include <QTimer>
 #include <QUrl>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const double kMinPlaybackRate = 0.1;
+const double kMaxPlaybackRate = 8.0;
+
+// Seeking costs about as much as grabbing five frames until measured
+const double kInitialGrabCostMs = 4.0;
+const double kInitialSeekCostMs = 20.0;
+const double kCostSmoothing = 0.1;
+
+// Hidden or minimised widgets get no swaps; a timer then keeps video following the clock
+const int kFallbackIntervalMs = 20;
+const qint64 kSwapTimeoutMs = 100;
+
+// Seeks that land past the wanted frame are retried this often, aiming earlier
+const int kSeekAttempts = 3;
+
+// Metrics scope of a standalone view; grid cells use their own
+const QString kDefaultMetricsScope = QStringLiteral("main");
+
+/**
+ * @brief Tessellates overlay primitives into one triangle list
+ *
+ * Everything (thick lines, outlines, filled shapes) becomes triangles with
+ * per-vertex colors, so the whole overlay is submitted in a single draw.
+ * Input points are logical widget pixels, output vertices are NDC.
+ */
+class OverlayTessellator
+{
+public:
+    OverlayTessellator(std::vector<GLfloat>& vertices, std::vector<GLubyte>& colors,
+                       int widgetWidth, int widgetHeight)
+        : m_vertices(vertices)
+        , m_colors(colors)
+        , m_scaleX(2.0f / std::max(1, widgetWidth))
+        , m_scaleY(2.0f / std::max(1, widgetHeight))
+    {
+        m_vertices.clear();
+        m_colors.clear();
+    }
+
+    void setColor(const QColor& color)
+    {
+        m_color[0] = static_cast<GLubyte>(color.red());
+        m_color[1] = static_cast<GLubyte>(color.green());
+        m_color[2] = static_cast<GLubyte>(color.blue());
+        m_color[3] = static_cast<GLubyte>(color.alpha());
+    }
+
+    void addQuad(const QPointF& a, const QPointF& b, const QPointF& c, const QPointF& d)
+    {
+        addVertex(a); addVertex(b); addVertex(c);
+        addVertex(a); addVertex(c); addVertex(d);
+    }
+
+    void addSegment(const QPointF& from, const QPointF& to, qreal thickness)
+    {
+        QPointF direction = to - from;
+        qreal length = std::hypot(direction.x(), direction.y());
+        if (length <= 0.0) {
+            return;
+        }
+
+        QPointF normal(-direction.y() / length, direction.x() / length);
+        normal *= thickness * 0.5;
+        addQuad(from + normal, to + normal, to - normal, from - normal);
+    }
+
+    void addRect(const QRectF& rect, qreal thickness, bool filled)
+    {
+        if (filled) {
+            addQuad(rect.topLeft(), rect.topRight(), rect.bottomRight(), rect.bottomLeft());
+            return;
+        }
+
+        // Four non-overlapping bands, so translucent corners aren't blended twice
+        qreal h = thickness * 0.5;
+        addBox(rect.left() - h, rect.top() - h, rect.right() + h, rect.top() + h);
+        addBox(rect.left() - h, rect.bottom() - h, rect.right() + h, rect.bottom() + h);
+        addBox(rect.left() - h, rect.top() + h, rect.left() + h, rect.bottom() - h);
+        addBox(rect.right() - h, rect.top() + h, rect.right() + h, rect.bottom() - h);
+    }
+
+    void addCircle(const QPointF& center, qreal radius, qreal thickness, bool filled)
+    {
+        if (radius <= 0.0) {
+            return;
+        }
+
+        int segments = qBound(12, static_cast<int>(radius * 0.5), 64);
+        qreal step = 2.0 * M_PI / segments;
+        qreal inner = filled ? 0.0 : std::max(0.0, radius - thickness * 0.5);
+        qreal outer = filled ? radius : radius + thickness * 0.5;
+
+        for (int i = 0; i < segments; ++i) {
+            QPointF d0(std::cos(i * step), std::sin(i * step));
+            QPointF d1(std::cos((i + 1) * step), std::sin((i + 1) * step));
+            if (filled) {
+                addVertex(center);
+                addVertex(center + d0 * outer);
+                addVertex(center + d1 * outer);
+            } else {
+                addQuad(center + d0 * inner, center + d0 * outer,
+                        center + d1 * outer, center + d1 * inner);
+            }
+        }
+    }
+
+    GLsizei vertexCount() const
+    {
+        return static_cast<GLsizei>(m_vertices.size() / 2);
+    }
+
+private:
+    void addBox(qreal left, qreal top, qreal right, qreal bottom)
+    {
+        if (right <= left || bottom <= top) {
+            return;
+        }
+        addQuad(QPointF(left, top), QPointF(right, top), QPointF(right, bottom), QPointF(left, bottom));
+    }
+
+    void addVertex(const QPointF& point)
+    {
+        m_vertices.push_back(static_cast<GLfloat>(point.x() * m_scaleX - 1.0f));
+        m_vertices.push_back(static_cast<GLfloat>(1.0f - point.y() * m_scaleY));
+        m_colors.insert(m_colors.end(), m_color, m_color + 4);
+    }
+
+    std::vector<GLfloat>& m_vertices;
+    std::vector<GLubyte>& m_colors;
+    GLfloat m_scaleX;
+    GLfloat m_scaleY;
+    GLubyte m_color[4] = {255, 255, 255, 255};
+};
+
+// Maps an overlay point to logical widget pixels
+QPointF mapOverlayPoint(const OverlayCommand& command, const cv::Point2f& point, const QRectF& videoRect)
+{
+    if (command.space == OverlayCommand::Space::Frame) {
+        return QPointF(videoRect.left() + point.x * videoRect.width(),
+                       videoRect.top() + point.y * videoRect.height());
+    }
+
+    qreal x = (command.anchor & Qt::AlignRight) ? videoRect.right() - point.x
+                                                 : videoRect.left() + point.x;
+    qreal y = (command.anchor & Qt::AlignBottom) ? videoRect.bottom() - point.y
+                                                  : videoRect.top() + point.y;
+    return QPointF(x, y);
+}
+
+} // namespace
 
 VideoGLWidget::VideoGLWidget(QWidget *parent)
     : QOpenGLWidget(parent)
     , m_textureId(0)
     , m_hasFrame(false)
     , m_glInitialized(false)
-    , m_frameTimer(nullptr)
+    , m_overlayVisible(true)
+    , m_showOriginal(false)
+    , m_fallbackTimer(nullptr)
     , m_mediaPlayer(nullptr)
     , m_audioOutput(nullptr)
     , m_fps(30.0)
     , m_totalFrames(0)
     , m_currentFrameIndex(0)
+    , m_firstFrameMs(0.0)
     , m_isPlaying(false)
     , m_syncCounter(0)
+    , m_playbackRate(1.0)
+    , m_interpolate(false)
+    , m_interpBaseIndex(-1)
+    , m_interpNextIndex(-1)
+    , m_sharedClock(nullptr)
+    , m_timeOffsetMs(0)
+    , m_audioEnabled(true)
+    , m_pendingIndex(-1)
+    , m_pendingSkipped(0)
+    , m_pendingTimeMs(0.0)
+    , m_grabCostMs(kInitialGrabCostMs)
+    , m_seekCostMs(kInitialSeekCostMs)
+    , m_framesDecoded(nullptr)
+    , m_framesPresented(nullptr)
+    , m_framesDropped(nullptr)
+    , m_presentLag(nullptr)
+    , m_avDrift(nullptr)
+    , m_decoderCharge(MemorySubsystem::DecoderBuffers)
     , m_pluginManager(nullptr)
+    , m_rawCaptureRemaining(0)
 {
     qDebug() << "[VideoGLWidget] Constructor called";
     setMinimumSize(320, 240);
@@ -27,17 +214,22 @@ VideoGLWidget::VideoGLWidget(QWidget *parent)
     format.setProfile(QSurfaceFormat::CompatibilityProfile);
     setFormat(format);
 
-    // Initialize timer for frame updates
-    m_frameTimer = new QTimer(this);
-    connect(m_frameTimer, &QTimer::timeout, this, &VideoGLWidget::updateVideoFrame);
+    // Presentation is paced by buffer swaps (vsync), not by a polling timer
+    connect(this, &QOpenGLWidget::frameSwapped, this, &VideoGLWidget::onFrameSwapped);
+
+    m_fallbackTimer = new QTimer(this);
+    m_fallbackTimer->setInterval(kFallbackIntervalMs);
+    connect(m_fallbackTimer, &QTimer::timeout, this, &VideoGLWidget::onFallbackTimer);
 
     // Initialize media player for audio
     m_audioOutput = new QAudioOutput(this);
     m_mediaPlayer = new QMediaPlayer(this);
     m_mediaPlayer->setAudioOutput(m_audioOutput);
+    connect(m_mediaPlayer, &QMediaPlayer::hasAudioChanged, this, &VideoGLWidget::updateClockSource);
 
     // Inicializar gerenciador de plugins
     m_pluginManager = new VideoPluginManager(this);
+    setMetricsScope(kDefaultMetricsScope);
 
     qDebug() << "[VideoGLWidget] OpenGL format configured: OpenGL 2.1 Compatibility";
 }
@@ -45,6 +237,13 @@ VideoGLWidget::VideoGLWidget(QWidget *parent)
 VideoGLWidget::~VideoGLWidget()
 {
     qDebug() << "[VideoGLWidget] Destructor called";
+
+    // Finish a capture quietly: receivers may already be half destroyed
+    // (MainWindow's status bar when the window closes)
+    if (m_rawCapture) {
+        m_rawCapture->close();
+        m_rawCapture.reset();
+    }
     stop();
     makeCurrent();
     deleteTexture();
@@ -69,10 +268,17 @@ void VideoGLWidget::resizeGL(int w, int h)
     glLoadIdentity();
     glOrtho(-1.0, 1.0, -1.0, 1.0, -1.0, 1.0);
     glMatrixMode(GL_MODELVIEW);
+
+    // Proxy processing sizes visual plugins to what is actually shown
+    if (m_pluginManager) {
+        qreal ratio = devicePixelRatioF();
+        m_pluginManager->setDisplaySize(cv::Size(qRound(w * ratio), qRound(h * ratio)));
+    }
 }
 
 void VideoGLWidget::paintGL()
 {
+    TRACE_SCOPE("paint", m_currentFrameIndex - 1);
     glClear(GL_COLOR_BUFFER_BIT);
 
     if (!m_hasFrame || m_textureId == 0) {
@@ -94,6 +300,11 @@ void VideoGLWidget::paintGL()
         scaleY = widgetAspect / imgAspect;
     }
 
+    // QPainter (overlay text) may have changed these on the previous frame
+    glEnable(GL_TEXTURE_2D);
+    glDisable(GL_BLEND);
+    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+
     glBindTexture(GL_TEXTURE_2D, m_textureId);
 
     glBegin(GL_QUADS);
@@ -104,44 +315,203 @@ void VideoGLWidget::paintGL()
     glEnd();
 
     glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (m_overlayVisible && !m_overlay.isEmpty()) {
+        // Video rectangle in logical widget pixels
+        qreal videoWidth = width() * scaleX;
+        qreal videoHeight = height() * scaleY;
+        QRectF videoRect((width() - videoWidth) / 2.0, (height() - videoHeight) / 2.0,
+                         videoWidth, videoHeight);
+
+        drawOverlayGeometry(videoRect);
+        drawOverlayText(videoRect);
+    }
 }
 
-void VideoGLWidget::updateFrame(const cv::Mat& frame)
+void VideoGLWidget::drawOverlayGeometry(const QRectF& videoRect)
 {
+    OverlayTessellator tessellator(m_overlayVertices, m_overlayColors, width(), height());
+
+    for (const OverlayCommand& command : m_overlay.commands()) {
+        tessellator.setColor(command.color);
+
+        switch (command.type) {
+            case OverlayCommand::Type::Line:
+                tessellator.addSegment(mapOverlayPoint(command, command.p1, videoRect),
+                                       mapOverlayPoint(command, command.p2, videoRect),
+                                       command.thickness);
+                break;
+
+            case OverlayCommand::Type::Circle: {
+                qreal radius = (command.space == OverlayCommand::Space::Frame)
+                                   ? command.radius * videoRect.width()
+                                   : command.radius;
+                tessellator.addCircle(mapOverlayPoint(command, command.p1, videoRect),
+                                      radius, command.thickness, command.filled);
+                break;
+            }
+
+            case OverlayCommand::Type::Rect: {
+                QRectF rect(mapOverlayPoint(command, command.p1, videoRect),
+                            mapOverlayPoint(command, command.p2, videoRect));
+                tessellator.addRect(rect.normalized(), command.thickness, command.filled);
+                break;
+            }
+
+            case OverlayCommand::Type::Text:
+                // Drawn by drawOverlayText
+                break;
+        }
+    }
+
+    if (tessellator.vertexCount() == 0) {
+        return;
+    }
+
+    // Single batched draw for all geometry
+    glDisable(GL_TEXTURE_2D);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+
+    glVertexPointer(2, GL_FLOAT, 0, m_overlayVertices.data());
+    glColorPointer(4, GL_UNSIGNED_BYTE, 0, m_overlayColors.data());
+    glDrawArrays(GL_TRIANGLES, 0, tessellator.vertexCount());
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisable(GL_BLEND);
+    glEnable(GL_TEXTURE_2D);
+}
+
+void VideoGLWidget::drawOverlayText(const QRectF& videoRect)
+{
+    bool hasText = std::any_of(m_overlay.commands().begin(), m_overlay.commands().end(),
+                               [](const OverlayCommand& command) {
+                                   return command.type == OverlayCommand::Type::Text;
+                               });
+    if (!hasText) {
+        return;
+    }
 
+    // Text is rendered at screen resolution, so labels stay sharp when scaled
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::TextAntialiasing);
+
+    QFont font = painter.font();
+    for (const OverlayCommand& command : m_overlay.commands()) {
+        if (command.type != OverlayCommand::Type::Text || command.text.isEmpty()) {
+            continue;
+        }
+
+        qreal fontSize = (command.space == OverlayCommand::Space::Frame)
+                             ? command.fontSize * videoRect.height()
+                             : command.fontSize;
+        font.setPixelSize(std::max(1, qRound(fontSize)));
+        painter.setFont(font);
+
+        QFontMetricsF metrics(font);
+        qreal padding = std::ceil(fontSize * 0.35);
+        QRectF box(0.0, 0.0,
+                   metrics.horizontalAdvance(command.text) + 2.0 * padding,
+                   metrics.height() + 2.0 * padding);
+
+        QPointF anchor = mapOverlayPoint(command, command.p1, videoRect);
+        if (command.anchor & Qt::AlignRight) {
+            box.moveRight(anchor.x());
+        } else {
+            box.moveLeft(anchor.x());
+        }
+        if (command.anchor & Qt::AlignBottom) {
+            box.moveBottom(anchor.y());
+        } else {
+            box.moveTop(anchor.y());
+        }
+
+        if (command.background.isValid() && command.background.alpha() > 0) {
+            painter.fillRect(box, command.background);
+        }
+
+        painter.setPen(command.color);
+        painter.drawText(box, Qt::AlignCenter, command.text);
+    }
+}
+
+void VideoGLWidget::updateFrame(const cv::Mat& frame)
+{
     if (frame.empty()) {
         return;
     }
 
+    showFrame(prepareFrame(frame, m_currentFrameIndex, m_overlay), m_currentFrameIndex);
+}
+
+cv::Mat VideoGLWidget::convertFrame(const cv::Mat& frame, qint64 frameIndex)
+{
     // Convert to RGB if necessary (optimized - avoid unnecessary clone)
     cv::Mat rgbFrame;
-    if (frame.channels() == 3) {
-        cv::cvtColor(frame, rgbFrame, cv::COLOR_BGR2RGB);
-    } else if (frame.channels() == 1) {
-        cv::cvtColor(frame, rgbFrame, cv::COLOR_GRAY2RGB);
-    } else if (frame.channels() == 4) {
-        cv::cvtColor(frame, rgbFrame, cv::COLOR_BGRA2RGB);
-    } else {
-        rgbFrame = frame.clone();
+    {
+        ScopedLatency timing(&m_convertLatency);
+        TRACE_SCOPE("convert", frameIndex);
+        if (frame.channels() == 3) {
+            cv::cvtColor(frame, rgbFrame, cv::COLOR_BGR2RGB);
+        } else if (frame.channels() == 1) {
+            cv::cvtColor(frame, rgbFrame, cv::COLOR_GRAY2RGB);
+        } else if (frame.channels() == 4) {
+            cv::cvtColor(frame, rgbFrame, cv::COLOR_BGRA2RGB);
+        } else {
+            rgbFrame = frame.clone();
+        }
+    }
+    return rgbFrame;
+}
+
+cv::Mat VideoGLWidget::prepareFrame(const cv::Mat& frame, qint64 frameIndex, OverlayCommandList& overlay)
+{
+    cv::Mat rgbFrame = convertFrame(frame, frameIndex);
+
+    if (m_rawCapture) {
+        captureRawFrame(rgbFrame, frameIndex);
     }
 
     // Processar frame com plugins (apenas se houver plugins habilitados)
     if (m_pluginManager && m_pluginManager->getEnabledPluginCount() > 0) {
-        qint64 timestamp = position();
-        m_pluginManager->processFrame(rgbFrame, timestamp, m_currentFrameIndex);
+        qint64 timestamp = framePts(frameIndex);
+        m_pluginManager->processFrame(rgbFrame, timestamp, frameIndex);
+        m_pluginManager->takeOverlayCommands(overlay);
+
+        // The original shares its buffer with the decoded frame, no copy here
+        if (m_showOriginal) {
+            cv::Mat original = m_pluginManager->originalFrame();
+            if (!original.empty()) {
+                rgbFrame = original;
+            }
+        }
+    } else {
+        overlay.clear();
     }
 
+    return rgbFrame;
+}
+
+void VideoGLWidget::showFrame(const cv::Mat& rgbFrame, qint64 frameIndex)
+{
     m_currentFrame = rgbFrame;
     m_hasFrame = true;
-
+    m_decoderCharge.set(static_cast<qint64>(m_currentFrame.total() * m_currentFrame.elemSize()
+                                            + m_interpBase.total() * m_interpBase.elemSize()
+                                            + m_interpNext.total() * m_interpNext.elemSize()));
 
     // Only create texture if OpenGL is already initialized
     if (m_glInitialized) {
+        ScopedLatency timing(&m_uploadLatency);
+        TRACE_SCOPE("upload", frameIndex);
         makeCurrent();
         createTexture();
         doneCurrent();
     } else {
-        qDebug() << "[VideoGLWidget] OpenGL not yet initialized, texture will be created in initializeGL";
+        LOG_DEBUG("VideoGLWidget", "OpenGL not yet initialized, texture will be created in initializeGL");
     }
     update();
 }
@@ -153,10 +523,40 @@ void VideoGLWidget::clearFrame()
     doneCurrent();
 
     m_currentFrame.release();
+    m_overlay.clear();
     m_hasFrame = false;
     update();
 }
 
+void VideoGLWidget::setOverlayVisible(bool visible)
+{
+    if (m_overlayVisible == visible) {
+        return;
+    }
+
+    // Only a repaint is needed, the frame itself is untouched by overlays
+    m_overlayVisible = visible;
+    update();
+}
+
+bool VideoGLWidget::isOverlayVisible() const
+{
+    return m_overlayVisible;
+}
+
+void VideoGLWidget::setShowOriginal(bool showOriginal)
+{
+    m_showOriginal = showOriginal;
+    if (m_pluginManager) {
+        m_pluginManager->setKeepOriginal(showOriginal);
+    }
+}
+
+bool VideoGLWidget::isShowingOriginal() const
+{
+    return m_showOriginal;
+}
+
 void VideoGLWidget::createTexture()
 {
 
@@ -186,9 +586,9 @@ void VideoGLWidget::createTexture()
 
     GLenum error = glGetError();
     if (error != GL_NO_ERROR) {
-        qWarning() << "[VideoGLWidget] OpenGL error after glTexImage2D:" << error;
+        LOG_WARNING("VideoGLWidget", "OpenGL error after glTexImage2D: %1", error);
     } else {
-        qDebug() << "[VideoGLWidget] Texture created successfully!";
+        LOG_TRACE("VideoGLWidget", "Texture created: %1x%2", m_currentFrame.cols, m_currentFrame.rows);
     }
 
     glBindTexture(GL_TEXTURE_2D, 0);
@@ -233,13 +633,23 @@ bool VideoGLWidget::loadVideo(const QString& videoPath)
     qDebug() << "  Dimensions:" << width << "x" << height;
     qDebug() << "  FPS:" << m_fps;
     qDebug() << "  Total frames:" << m_totalFrames;
-    qDebug() << "  Duration:" << (m_totalFrames / m_fps) << "seconds";
+    qDebug() << "  Duration:" << (m_totalFrames / m_fps) << "seconds (nominal)";
+
+    // Variable frame rate files only get exact timing from the frames themselves
+    m_timestamps.build(videoPath, m_fps, m_totalFrames);
+
+    // Seeks go by stream time, which need not start at 0
+    m_firstFrameMs = m_videoCapture.grab() ? m_videoCapture.get(cv::CAP_PROP_POS_MSEC) : 0.0;
+    m_videoCapture.set(cv::CAP_PROP_POS_FRAMES, 0);
 
     // Configure audio
     m_mediaPlayer->setSource(QUrl::fromLocalFile(videoPath));
     m_audioOutput->setVolume(1.0);
 
     m_currentFrameIndex = 0;
+    m_clock.pause();
+    m_clock.seek(0);
+    updateClockSource();
 
     // Initialize plugins with video information
     if (m_pluginManager) {
@@ -249,6 +659,7 @@ bool VideoGLWidget::loadVideo(const QString& videoPath)
         videoInfo["fps"] = m_fps;
         videoInfo["totalFrames"] = m_totalFrames;
         videoInfo["duration"] = static_cast<qint64>((m_totalFrames / m_fps) * 1000.0);
+        videoInfo["metricsScope"] = m_metricsScope;
         m_pluginManager->initializePlugins(videoInfo);
     }
 
@@ -276,11 +687,19 @@ void VideoGLWidget::play()
     }
 
     // Start audio FIRST (it is the master clock)
-    m_mediaPlayer->play();
+    if (m_audioEnabled) {
+        m_mediaPlayer->play();
+    }
+    if (!m_sharedClock) {
+        m_clock.start(m_clock.nowMs());
+    }
 
-    // Fast timer to update video based on audio position
-    // Verifica a cada 16ms (~60fps) qual frame deveria estar exibindo
-    m_frameTimer->start(16);
+    // Kick off the vsync loop; every swap schedules the next repaint
+    QScreen* currentScreen = screen();
+    m_scheduler.reset(currentScreen ? currentScreen->refreshRate() : 60.0);
+    m_swapTimer.start();
+    m_fallbackTimer->start();
+    update();
 }
 
 void VideoGLWidget::pause()
@@ -298,11 +717,11 @@ void VideoGLWidget::pause()
         m_pluginManager->notifyPlaybackPaused();
     }
 
-    // Parar timer
-    m_frameTimer->stop();
+    m_fallbackTimer->stop();
 
     // Pause audio
     m_mediaPlayer->pause();
+    m_clock.pause();
 }
 
 void VideoGLWidget::stop()
@@ -310,16 +729,15 @@ void VideoGLWidget::stop()
     qDebug() << "[VideoGLWidget] Stopping playback";
 
     m_isPlaying = false;
+    if (m_fallbackTimer) {
+        m_fallbackTimer->stop();
+    }
 
     // Notificar plugins
     if (m_pluginManager) {
         m_pluginManager->notifyPlaybackStopped();
     }
 
-    if (m_frameTimer) {
-        m_frameTimer->stop();
-    }
-
     if (m_mediaPlayer) {
         m_mediaPlayer->stop();
     }
@@ -329,6 +747,9 @@ void VideoGLWidget::stop()
     }
 
     m_currentFrameIndex = 0;
+    m_clock.pause();
+    m_clock.seek(0);
+    resetInterpolation();
     clearFrame();
 }
 
@@ -341,25 +762,34 @@ void VideoGLWidget::seek(qint64 positionMs)
 
     qDebug() << "[VideoGLWidget] Seeking position:" << positionMs << "ms";
 
-    // Calculate corresponding frame
-    double positionSec = positionMs / 1000.0;
-    qint64 targetFrame = static_cast<qint64>(positionSec * m_fps);
+    // Frame on screen at that time (bounded by the index)
+    qint64 targetFrame = std::max<qint64>(0, m_timestamps.frameAt(positionMs));
 
-    // Limitar aos bounds
-    if (targetFrame < 0) targetFrame = 0;
-    if (targetFrame >= m_totalFrames) targetFrame = m_totalFrames - 1;
+    // Notificar plugins; with a checkpoint restored they resume right after it
+    qint64 replayFrom = targetFrame;
+    if (m_pluginManager) {
+        qint64 checkpointFrame = m_pluginManager->notifySeek(framePts(targetFrame));
+        if (checkpointFrame >= 0 && checkpointFrame < targetFrame) {
+            replayFrom = checkpointFrame + 1;
+        }
+    }
 
-    // Position video
-    m_videoCapture.set(cv::CAP_PROP_POS_FRAMES, targetFrame);
-    m_currentFrameIndex = targetFrame;
+    // Position video; the seek may land a few frames early
+    if (!seekCapture(replayFrom)) {
+        // Audio, clock and plugins follow the video back to the start
+        qWarning() << "[VideoGLWidget] Seek to frame" << replayFrom << "failed, rewound to the start";
+        positionMs = 0;
+        targetFrame = 0;
+        if (m_pluginManager) {
+            m_pluginManager->notifySeek(0);
+        }
+    }
+    replayFrames(replayFrom, targetFrame);
+    resetInterpolation();
 
-    // Position audio
+    // Position audio, and the clock with it
     m_mediaPlayer->setPosition(positionMs);
-    
-    // Notificar plugins
-    if (m_pluginManager) {
-        m_pluginManager->notifySeek(positionMs);
-    }
+    m_clock.seek(qBound<qint64>(0, positionMs, duration()));
     
     // Ler e exibir o frame atual
     cv::Mat frame;
@@ -368,7 +798,7 @@ void VideoGLWidget::seek(qint64 positionMs)
         m_currentFrameIndex++;
     }
 
-    qDebug() << "[VideoGLWidget] Positioned at frame:" << targetFrame;
+    qDebug() << "[VideoGLWidget] Positioned at frame:" << m_currentFrameIndex - 1;
 }
 
 void VideoGLWidget::forward(qint64 ms)
@@ -399,6 +829,141 @@ void VideoGLWidget::backward(qint64 ms)
     seek(newPos);
 }
 
+void VideoGLWidget::setPlaybackRate(double rate)
+{
+    rate = qBound(kMinPlaybackRate, rate, kMaxPlaybackRate);
+    if (rate == m_playbackRate) {
+        return;
+    }
+
+    qDebug() << "[VideoGLWidget] Playback rate:" << rate;
+    m_playbackRate = rate;
+    m_mediaPlayer->setPlaybackRate(rate);
+    m_clock.setRate(rate);
+    resetInterpolation();
+}
+
+double VideoGLWidget::playbackRate() const
+{
+    return m_playbackRate;
+}
+
+void VideoGLWidget::setSlowMotionInterpolation(bool enabled)
+{
+    m_interpolate = enabled;
+    resetInterpolation();
+}
+
+bool VideoGLWidget::isSlowMotionInterpolation() const
+{
+    return m_interpolate;
+}
+
+void VideoGLWidget::setSharedClock(const MediaClock* clock)
+{
+    m_sharedClock = clock;
+    m_pendingFrame.release();
+    m_pendingIndex = -1;
+}
+
+void VideoGLWidget::setTimeOffset(qint64 offsetMs)
+{
+    m_timeOffsetMs = offsetMs;
+}
+
+qint64 VideoGLWidget::timeOffset() const
+{
+    return m_timeOffsetMs;
+}
+
+void VideoGLWidget::setMetricsScope(const QString& scope)
+{
+    MetricsRegistry& registry = MetricsRegistry::instance();
+    m_metricsScope = scope;
+    m_framesDecoded = &registry.counter(MetricNames::scoped(scope, MetricNames::FramesDecoded));
+    m_framesPresented = &registry.counter(MetricNames::scoped(scope, MetricNames::FramesPresented));
+    m_framesDropped = &registry.counter(MetricNames::scoped(scope, MetricNames::FramesDropped));
+    m_presentLag = &registry.gauge(MetricNames::scoped(scope, MetricNames::PresentLagMs));
+    m_avDrift = &registry.gauge(MetricNames::scoped(scope, MetricNames::AvDriftMs));
+
+    if (m_pluginManager) {
+        m_pluginManager->setMetricsScope(scope);
+    }
+}
+
+QString VideoGLWidget::metricsScope() const
+{
+    return m_metricsScope;
+}
+
+void VideoGLWidget::setAudioEnabled(bool enabled)
+{
+    m_audioEnabled = enabled;
+    m_audioOutput->setMuted(!enabled);
+    if (!enabled) {
+        if (m_mediaPlayer->playbackState() == QMediaPlayer::PlayingState) {
+            m_mediaPlayer->pause();
+        }
+    } else if (m_isPlaying) {
+        m_mediaPlayer->play();
+    }
+}
+
+bool VideoGLWidget::isAudible() const
+{
+    // Silent videos and machines without an output device run on the timer alone
+    return m_audioEnabled && m_mediaPlayer->hasAudio() && !QMediaDevices::audioOutputs().isEmpty();
+}
+
+qint64 VideoGLWidget::audioPosition() const
+{
+    return m_mediaPlayer->position();
+}
+
+bool VideoGLWidget::decodeForClock(double clockMs)
+{
+    m_pendingFrame.release();
+    m_pendingIndex = -1;
+    if (!m_videoCapture.isOpened()) {
+        return false;
+    }
+
+    // Before its offset a stream holds its first frame, after its end the last one
+    const double streamTime = clockMs + m_timeOffsetMs;
+    qint64 targetFrame = std::max<qint64>(0, m_timestamps.nearestFrame(streamTime));
+    if (targetFrame < m_currentFrameIndex) {
+        return streamTime < duration();
+    }
+
+    m_pendingSkipped = targetFrame - m_currentFrameIndex;
+    if (!decodeFrame(targetFrame, m_pendingFrame)) {
+        m_pendingFrame.release();
+        return false;
+    }
+    m_pendingIndex = targetFrame;
+    m_pendingTimeMs = streamTime;
+    return true;
+}
+
+void VideoGLWidget::presentDecoded()
+{
+    if (m_pendingIndex < 0) {
+        m_scheduler.recordRepeated();
+        return;
+    }
+
+    TRACE_SCOPE("present", m_pendingIndex);
+    showFrame(prepareFrame(m_pendingFrame, m_pendingIndex, m_overlay), m_pendingIndex);
+    m_pendingFrame.release();
+    m_framesPresented->add();
+
+    const double ptsMs = static_cast<double>(framePts(m_pendingIndex));
+    m_presentLag->set(m_pendingTimeMs - ptsMs);
+    m_avDrift->set(m_sharedClock ? m_sharedClock->driftMs() : m_clock.driftMs()); // Grid: its first view's audio
+    m_scheduler.recordPresented(ptsMs, m_pendingTimeMs, m_pendingSkipped);
+    m_pendingIndex = -1;
+}
+
 bool VideoGLWidget::isPlaying() const
 {
     return m_isPlaying;
@@ -409,7 +974,25 @@ qint64 VideoGLWidget::position() const
     if (!m_videoCapture.isOpened()) {
         return 0;
     }
-    return static_cast<qint64>((m_currentFrameIndex / m_fps) * 1000.0);
+    // Smooth between frames; frames themselves are stamped with framePts()
+    return qBound<qint64>(0, static_cast<qint64>(clockMs()), duration());
+}
+
+double VideoGLWidget::clockMs() const
+{
+    return m_sharedClock ? m_sharedClock->nowMs() + m_timeOffsetMs : m_clock.nowMs();
+}
+
+qint64 VideoGLWidget::framePts(qint64 frameIndex) const
+{
+    return m_timestamps.ptsMs(frameIndex);
+}
+
+void VideoGLWidget::updateClockSource()
+{
+    bool audible = isAudible();
+    m_clock.setSource(audible ? MediaClock::Source::Audio : MediaClock::Source::FreeRun);
+    qDebug() << "[VideoGLWidget] Media clock:" << (audible ? "audio" : "free-running");
 }
 
 qint64 VideoGLWidget::duration() const
@@ -417,7 +1000,7 @@ qint64 VideoGLWidget::duration() const
     if (!m_videoCapture.isOpened()) {
         return 0;
     }
-    return static_cast<qint64>((m_totalFrames / m_fps) * 1000.0);
+    return m_timestamps.durationMs();
 }
 
 double VideoGLWidget::getFps() const
@@ -425,53 +1008,376 @@ double VideoGLWidget::getFps() const
     return m_fps;
 }
 
+PresentationStats VideoGLWidget::presentationStats() const
+{
+    return m_scheduler.stats();
+}
+
+QList<QPair<QString, LatencyStats>> VideoGLWidget::pipelineLatencies() const
+{
+    QList<QPair<QString, LatencyStats>> stages;
+    stages.append(qMakePair(QStringLiteral("Decode"), m_decodeLatency.stats()));
+    stages.append(qMakePair(QStringLiteral("Convert"), m_convertLatency.stats()));
+    if (m_pluginManager) {
+        stages.append(qMakePair(QStringLiteral("Plugins"), m_pluginManager->getChainLatency()));
+    }
+    stages.append(qMakePair(QStringLiteral("Upload"), m_uploadLatency.stats()));
+    return stages;
+}
+
+void VideoGLWidget::resetLatencyStats()
+{
+    m_decodeLatency.reset();
+    m_convertLatency.reset();
+    m_uploadLatency.reset();
+    if (m_pluginManager) {
+        m_pluginManager->resetLatencyStats();
+    }
+}
+
 VideoPluginManager* VideoGLWidget::pluginManager()
 {
     return m_pluginManager;
 }
 
-void VideoGLWidget::updateVideoFrame()
+bool VideoGLWidget::startRawCapture(const QString& path, int frameCount)
 {
-    if (!m_videoCapture.isOpened() || !m_isPlaying) {
+    stopRawCapture();
+
+    if (frameCount <= 0) {
+        return false;
+    }
+
+    auto writer = std::make_unique<RawFrameWriter>();
+    if (!writer->open(path, m_fps, RawFrameFileHeader::RGB)) {
+        return false;
+    }
+
+    m_rawCapture = std::move(writer);
+    m_rawCaptureRemaining = frameCount;
+    qDebug() << "[VideoGLWidget] Capturing" << frameCount << "raw frames to" << path;
+    return true;
+}
+
+void VideoGLWidget::stopRawCapture()
+{
+    if (!m_rawCapture) {
         return;
     }
 
-    // Get current audio position (master clock)
-    qint64 audioPos = m_mediaPlayer->position();
+    // Release first so a slot reacting to the signal can start a new capture
+    std::unique_ptr<RawFrameWriter> writer = std::move(m_rawCapture);
+    m_rawCaptureRemaining = 0;
 
-    // Calcular qual frame deveria estar sendo exibido
-    qint64 targetFrame = static_cast<qint64>((audioPos / 1000.0) * m_fps);
+    const QString path = writer->path();
+    const qint64 frames = writer->frameCount();
+    writer->close();
+    emit rawCaptureFinished(path, frames);
+}
 
-    // If already at correct frame or ahead, do nothing
-    if (m_currentFrameIndex >= targetFrame) {
+bool VideoGLWidget::isRawCapturing() const
+{
+    return m_rawCapture != nullptr;
+}
+
+void VideoGLWidget::captureRawFrame(const cv::Mat& rgbFrame, qint64 frameIndex)
+{
+    // Written synchronously: playback may stutter while capturing, the
+    // captured frames themselves are unaffected
+    if (!m_rawCapture->append(rgbFrame, framePts(frameIndex), frameIndex)) {
+        qWarning() << "[VideoGLWidget] Raw capture failed, stopping";
+        stopRawCapture();
         return;
     }
 
-    // Se estamos muito atrasados (>5 frames), pular frames
-    if (targetFrame - m_currentFrameIndex > 5) {
-        qDebug() << "[VideoGLWidget] Skipping frames to catch up with audio. From" << m_currentFrameIndex << "to" << targetFrame;
-        m_videoCapture.set(cv::CAP_PROP_POS_FRAMES, targetFrame);
-        m_currentFrameIndex = targetFrame;
+    if (--m_rawCaptureRemaining <= 0) {
+        stopRawCapture();
     }
+}
 
-    // Read and display frames until reaching audio position
-    while (m_currentFrameIndex < targetFrame) {
-        cv::Mat frame;
-        bool success = m_videoCapture.read(frame);
+void VideoGLWidget::onFrameSwapped()
+{
+    if (!m_isPlaying) {
+        return;
+    }
+
+    // Time between the end of "paint" and this event is spent waiting for the swap
+    TRACE_INSTANT("vsync", m_currentFrameIndex);
+    m_swapTimer.restart();
+    m_scheduler.onVsync();
+    advancePresentation();
+}
+
+void VideoGLWidget::onFallbackTimer()
+{
+    if (!m_isPlaying || m_swapTimer.elapsed() < kSwapTimeoutMs) {
+        return;
+    }
+    advancePresentation();
+}
+
+void VideoGLWidget::advancePresentation()
+{
+    emit presentationDue();
+
+    // A multi-view grid presents all of its views together
+    if (m_sharedClock) {
+        return;
+    }
+
+    presentNextFrame();
 
-        if (!success || frame.empty()) {
-            qDebug() << "[VideoGLWidget] End of video reached";
-            stop();
+    // Keep the loop running: the next swap happens on the next vsync
+    if (m_isPlaying) {
+        update();
+    }
+}
+
+void VideoGLWidget::presentNextFrame()
+{
+    if (!m_videoCapture.isOpened()) {
+        return;
+    }
+
+    // Audio stays the master; the clock interpolates between its coarse reports
+    m_clock.updateAudio(m_mediaPlayer->position());
+    m_avDrift->set(m_clock.driftMs());
+
+    // Media time when the next swap becomes visible
+    double displayTime = m_scheduler.displayTimeMs(m_clock.nowMs(), m_clock.rate());
+
+    if (m_interpolate && m_playbackRate < 1.0) {
+        presentInterpolated(displayTime);
+        return;
+    }
+
+    // Frame whose PTS is nearest to it
+    qint64 targetFrame = std::max<qint64>(0, m_timestamps.nearestFrame(displayTime));
+
+    // m_currentFrameIndex is the next frame to be read; the one on screen is behind it
+    if (targetFrame < m_currentFrameIndex) {
+        m_scheduler.recordRepeated();
+        return;
+    }
+
+    TRACE_SCOPE("present", targetFrame);
+    qint64 skipped = targetFrame - m_currentFrameIndex;
+
+    cv::Mat frame;
+    if (!decodeFrame(targetFrame, frame)) {
+        qDebug() << "[VideoGLWidget] End of video reached";
+        stop();
+        return;
+    }
+
+    // Plugins only see frames that are actually shown
+    showFrame(prepareFrame(frame, targetFrame, m_overlay), targetFrame);
+    m_framesPresented->add();
+
+    // Positive: the frame shown is behind the media clock
+    const double ptsMs = static_cast<double>(framePts(targetFrame));
+    m_presentLag->set(displayTime - ptsMs);
+
+    m_scheduler.recordPresented(ptsMs, displayTime, skipped);
+}
+
+void VideoGLWidget::presentInterpolated(double displayTime)
+{
+    // Frame on screen at the display time and the one after it, both processed once
+    const qint64 base = std::max<qint64>(0, m_timestamps.frameAt(static_cast<qint64>(displayTime)));
+    const qint64 next = base + 1;
+    TRACE_SCOPE("present", base);
+
+    if (base != m_interpBaseIndex) {
+        if (base == m_interpNextIndex) {
+            // The lookahead frame is due
+            m_interpBase = m_interpNext;
+            m_overlay.swap(m_interpNextOverlay);
+            m_interpNext.release();
+            m_interpNextIndex = -1;
+        } else if (base == m_currentFrameIndex - 1 && m_hasFrame && m_interpBaseIndex < 0) {
+            // Entering slow motion: the frame already on screen is the base
+            m_interpBase = m_currentFrame;
+        } else if (base >= m_currentFrameIndex) {
+            cv::Mat frame;
+            if (!decodeFrame(base, frame)) {
+                qDebug() << "[VideoGLWidget] End of video reached";
+                stop();
+                return;
+            }
+            m_interpBase = prepareFrame(frame, base, m_overlay);
+        } else {
+            // Behind the decoder (only right after a rate change); hold the current frame
+            m_scheduler.recordRepeated();
             return;
         }
+        m_interpBaseIndex = base;
+    }
+
+    if (m_interpNextIndex != next && next == m_currentFrameIndex) {
+        cv::Mat frame;
+        if (decodeFrame(next, frame)) {
+            m_interpNext = prepareFrame(frame, next, m_interpNextOverlay);
+            m_interpNextIndex = next;
+        }
+    }
+
+    // Last frame of the video: nothing to blend towards
+    if (m_interpNextIndex != next) {
+        showFrame(m_interpBase, base);
+        m_framesPresented->add();
+        m_scheduler.recordPresented(framePts(base), displayTime, 0);
+        return;
+    }
+
+    const double basePts = static_cast<double>(framePts(base));
+    const double nextPts = static_cast<double>(framePts(next));
+    const double t = nextPts > basePts ? qBound(0.0, (displayTime - basePts) / (nextPts - basePts), 1.0) : 0.0;
+
+    // Proxy processing may hand back frames of different sizes; then just hold the base
+    if (m_interpBase.size() == m_interpNext.size() && m_interpBase.type() == m_interpNext.type()) {
+        TRACE_SCOPE("blend", base);
+        cv::addWeighted(m_interpBase, 1.0 - t, m_interpNext, t, 0.0, m_blendBuffer);
+        showFrame(m_blendBuffer, base);
+    } else {
+        showFrame(m_interpBase, base);
+    }
+    m_framesPresented->add();
+
+    const double ptsMs = basePts + t * (nextPts - basePts);
+    m_presentLag->set(displayTime - ptsMs);
+    m_scheduler.recordPresented(ptsMs, displayTime, 0);
+}
+
+bool VideoGLWidget::decodeFrame(qint64 targetFrame, cv::Mat& frame)
+{
+    qint64 skipped = targetFrame - m_currentFrameIndex;
+    m_framesDropped->add(skipped);
+
+    // A seek restarts decoding from a keyframe; only worth it when grabbing
+    // the frames in between would take longer (high rates, long stalls)
+    if (skipped > 0 && skipped * m_grabCostMs > m_seekCostMs) {
+        LOG_DEBUG("VideoGLWidget", "Seeking to catch up with the clock. From %1 to %2",
+                  m_currentFrameIndex, targetFrame);
+        QElapsedTimer timer;
+        timer.start();
+        const bool positioned = seekCapture(targetFrame);
+        m_seekCostMs += (timer.nsecsElapsed() / 1e6 - m_seekCostMs) * kCostSmoothing;
+        if (!positioned) {
+            return false;
+        }
+    }
 
+    // Frames that won't be shown are only grabbed, not retrieved
+    while (m_currentFrameIndex < targetFrame) {
+        TRACE_SCOPE("grab", m_currentFrameIndex);
+        QElapsedTimer timer;
+        timer.start();
+        if (!m_videoCapture.grab()) {
+            return false;
+        }
+        m_grabCostMs += (timer.nsecsElapsed() / 1e6 - m_grabCostMs) * kCostSmoothing;
         m_currentFrameIndex++;
+    }
+
+    // Plugins, the overlay and raw captures take the frame to be targetFrame
+    if (m_currentFrameIndex != targetFrame) {
+        return false;
+    }
 
-        // Only update screen on last necessary frame
-        if (m_currentFrameIndex >= targetFrame) {
-            updateFrame(frame);
+    bool decoded;
+    {
+        ScopedLatency timing(&m_decodeLatency);
+        TRACE_SCOPE("decode", targetFrame);
+        decoded = m_videoCapture.read(frame);
+    }
+    if (!decoded || frame.empty()) {
+        return false;
+    }
+
+    m_currentFrameIndex++;
+    m_framesDecoded->add();
+    return true;
+}
+
+void VideoGLWidget::replayFrames(qint64 fromFrame, qint64 toFrame)
+{
+    const bool replay = m_pluginManager && m_pluginManager->getEnabledPluginCount() > 0;
+    cv::Mat frame;
+    OverlayCommandList overlay;
+
+    // Frames before the first one plugins need are only grabbed
+    while (m_currentFrameIndex < toFrame) {
+        if (!replay || m_currentFrameIndex < fromFrame) {
+            if (!m_videoCapture.grab()) {
+                return;
+            }
+            m_currentFrameIndex++;
+            continue;
         }
+
+        // Plugin state catches up from the restored checkpoint; nothing is shown
+        TRACE_SCOPE("replay", m_currentFrameIndex);
+        if (!m_videoCapture.read(frame) || frame.empty()) {
+            return;
+        }
+        cv::Mat rgbFrame = convertFrame(frame, m_currentFrameIndex);
+        m_pluginManager->processFrame(rgbFrame, framePts(m_currentFrameIndex), m_currentFrameIndex);
+        m_pluginManager->takeOverlayCommands(overlay);
+        m_currentFrameIndex++;
+    }
+}
+
+bool VideoGLWidget::seekCapture(qint64 targetFrame)
+{
+    if (targetFrame <= 0) {
+        m_videoCapture.set(cv::CAP_PROP_POS_FRAMES, 0);
+        m_currentFrameIndex = 0;
+        return true;
+    }
+
+    // Backends turn a seek time into a frame number at the nominal rate, which
+    // misses on variable frame rate files. Aim one frame early and identify the
+    // frame landed on by its timestamp, the same way the index was built.
+    double aimMs = static_cast<double>(framePts(targetFrame - 1));
+    for (int attempt = 0; attempt < kSeekAttempts; ++attempt) {
+        m_videoCapture.set(cv::CAP_PROP_POS_MSEC, m_firstFrameMs + std::max(0.0, aimMs));
+        if (!m_videoCapture.grab()) {
+            // The decoder has moved somewhere unknown; put it back where the index is known
+            m_videoCapture.set(cv::CAP_PROP_POS_FRAMES, 0);
+            m_currentFrameIndex = 0;
+            return false;
+        }
+
+        const double landedMs = m_videoCapture.get(cv::CAP_PROP_POS_MSEC) - m_firstFrameMs;
+        const qint64 landed = std::max<qint64>(0, m_timestamps.nearestFrame(landedMs));
+        m_currentFrameIndex = landed + 1;
+        if (landed < targetFrame) {
+            return true;
+        }
+        if (aimMs <= 0.0) {
+            break;
+        }
+
+        // Past the target: aim earlier by as much as this attempt overshot
+        aimMs -= static_cast<double>(framePts(landed) - framePts(targetFrame - 1));
     }
+
+    // Callers grab forward to the target, so never leave the decoder past it.
+    // The start of the file is the one position every backend seeks to exactly.
+    LOG_WARNING("VideoGLWidget", "Seek kept landing past frame %1, decoding from the start", targetFrame);
+    m_videoCapture.set(cv::CAP_PROP_POS_FRAMES, 0);
+    m_currentFrameIndex = 0;
+    return true;
+}
+
+void VideoGLWidget::resetInterpolation()
+{
+    m_interpBase.release();
+    m_interpNext.release();
+    m_interpNextOverlay.clear();
+    m_interpBaseIndex = -1;
+    m_interpNextIndex = -1;
 }
 
 void VideoGLWidget::syncAudioToVideo()